@@ -0,0 +1,215 @@
+#include "../libs/intern/StringPool.h"
+#include "../libs/random/Random.h"
+#include "../libs/timer/Timer.h"
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility> // for std::move
+#include <vector>
+
+// Every monster has one of a few names and roars, so there's no need for each of them to own a copy
+StringPool pool{};
+
+// Monster from 15.x_1 with interned strings: 4-byte ids instead of two std::strings
+class Monster
+{
+public:
+  enum Type {
+    dragon,
+    goblin,
+    ogre,
+    orc,
+    skeleton,
+    troll,
+    vampire,
+    zombie,
+    maxMonsterTypes, // must be last
+  };
+
+  Monster(Type t, std::string_view n, std::string_view r, int hp)
+    : m_type{ t }, m_name{ pool.intern(n) }, m_roar{ pool.intern(r) }, m_hitPoints{ hp }
+  {}
+
+  std::string_view getName() const { return pool.view(m_name); }
+  Symbol getNameSymbol() const { return m_name; }
+
+  void print() const
+  {
+    std::cout << pool.view(m_name);
+    if (m_hitPoints > 0) {
+      std::cout << " has " << m_hitPoints << " and says " << pool.view(m_roar) << ".\n";
+    } else {
+      std::cout << " is dead.\n";
+    }
+  }
+
+private:
+  Type m_type{};
+  Symbol m_name{};
+  Symbol m_roar{};
+  int m_hitPoints{};
+};
+
+// The same monster with owned strings, for comparison
+struct StringMonster
+{
+  Monster::Type type{};
+  std::string name{};
+  std::string roar{};
+  int hitPoints{};
+};
+
+// Car from 21.7_2: comparing two cars compares two pairs of integers
+class Car
+{
+public:
+  Car(std::string_view make, std::string_view model) : m_make{ pool.intern(make) }, m_model{ pool.intern(model) } {}
+
+  friend bool operator==(const Car& c1, const Car& c2) = default;
+
+  friend std::ostream& operator<<(std::ostream& out, const Car& c)
+  {
+    return out << '(' << pool.view(c.m_make) << ", " << pool.view(c.m_model) << ')';
+  }
+
+private:
+  Symbol m_make{};
+  Symbol m_model{};
+};
+
+// Creature from 24.x_3: every orc, slime and dragon of a game shares its name
+class Creature
+{
+public:
+  Creature(std::string_view name, char symbol, int health, int damage, int gold)
+    : m_name{ pool.intern(name) }, m_symbol{ symbol }, m_health{ health }, m_damage{ damage }, m_gold{ gold }
+  {}
+
+  std::string_view getName() const { return pool.view(m_name); }
+  Symbol getNameSymbol() const { return m_name; }
+  char getSymbol() const { return m_symbol; }
+  int getHealth() const { return m_health; }
+  int getDamage() const { return m_damage; }
+  int getGold() const { return m_gold; }
+
+private:
+  Symbol m_name{};
+  char m_symbol{};
+  int m_health{};
+  int m_damage{};
+  int m_gold{};
+};
+
+// Teacher from 23.3_2
+class Teacher
+{
+public:
+  Teacher(std::string_view name) : m_name{ pool.intern(name) } {}
+
+  std::string_view getName() const { return pool.view(m_name); }
+  friend bool operator==(const Teacher& t1, const Teacher& t2) = default;
+
+private:
+  Symbol m_name{};
+};
+
+// Fruit from 24.x_2: thousands of fruits, a handful of names and colors
+class Fruit
+{
+public:
+  Fruit(std::string_view name, std::string_view color) : m_name{ pool.intern(name) }, m_color{ pool.intern(color) } {}
+
+  std::string_view getName() const { return pool.view(m_name); }
+  std::string_view getColor() const { return pool.view(m_color); }
+  friend bool operator==(const Fruit& f1, const Fruit& f2) = default;
+
+private:
+  Symbol m_name{};
+  Symbol m_color{};
+};
+
+int main()
+{
+  Monster skeleton{ Monster::skeleton, "Bones", "*rattle*", 4 };
+  skeleton.print();
+  Monster vampire{ Monster::vampire, "Nibblez", "*hiss*", 0 };
+  vampire.print();
+
+  // equal strings get equal symbols, and the views point into the same characters
+  Symbol a{ pool.intern("Bones") };
+  assert(a == skeleton.getNameSymbol() && pool.view(a).data() == skeleton.getName().data());
+  assert(pool.find("Nibblez") && !pool.find("Moog"));
+  assert(pool.view(Symbol{}).empty());
+
+  Car c1{ "Toyota", "Corolla" };
+  Car c2{ std::string{ "Toyota" }, std::string{ "Corolla" } };
+  assert(c1 == c2 && !(c1 == Car{ "Toyota", "Camry" }));
+  std::cout << c1 << '\n';
+
+  std::unordered_set<Symbol> seen{ a, pool.intern("Bones"), pool.intern("Nibblez") };
+  assert(seen.size() == 2);
+
+  Creature orc{ "orc", 'o', 4, 2, 25 };
+  Creature otherOrc{ std::string{ "orc" }, 'o', 4, 2, 25 };
+  assert(orc.getNameSymbol() == otherOrc.getNameSymbol() && orc.getName() == "orc" && orc.getGold() == 25);
+  Teacher bob{ "Bob" };
+  assert(bob == Teacher{ "Bob" } && !(bob == Teacher{ "Frank" }) && bob.getName() == "Bob");
+  Fruit apple{ "apple", "red" };
+  Fruit banana{ "banana", "yellow" };
+  assert(apple == Fruit("apple", "red") && !(apple == Fruit("apple", "green")) && banana.getColor() == "yellow");
+  std::cout << "My " << apple.getName() << " is " << apple.getColor() << ".\n";
+
+  // a moved-from pool starts over with only the empty string
+  StringPool first{};
+  Symbol hello{ first.intern("hello") };
+  StringPool second{ std::move(first) };
+  assert(second.view(hello) == "hello" && first.size() == 1 && !first.find("hello"));
+  assert(first.intern("again") == hello && first.view(hello) == "again");
+  first = std::move(second);
+  assert(first.view(hello) == "hello" && second.size() == 1 && second.intern("") == Symbol{});
+
+  // long enough not to fit into std::string's small buffer
+  constexpr std::array names{ "Blarg the Unrelenting", "Moog of the Deep Caves", "Pksh the Foul-Smelling",
+    "Tyrn, Eater of Villages", "Mort the Undying Horror", "Hans from Accounting, Cursed" };
+  constexpr std::array roars{ "*ROAR* *ROAR* *ROAR* *ROAR*", "*peep* *peep* *peep* *peep*",
+    "*squeal* *squeal* *squeal*", "*whine* *whine* *whine* *whine*", "*growl* *growl* *growl* *growl*",
+    "*burp* *burp* *burp* *burp*" };
+
+  constexpr std::size_t count{ 2'000'000 };
+  std::vector<std::size_t> picks(count);
+  for (auto& p : picks) p = Random::get<std::size_t>(0, 5);
+
+  Timer t{};
+  std::vector<StringMonster> stringMonsters{};
+  stringMonsters.reserve(count);
+  for (std::size_t p : picks) stringMonsters.push_back({ Monster::orc, names[p], roars[p], 10 });
+  std::cout << "std::string monsters: created in " << t.elapsed() << " s, about "
+            << count * (sizeof(StringMonster) + 2 * 32) / (1024 * 1024) << " MB\n";
+
+  t.reset();
+  std::vector<Monster> monsters{};
+  monsters.reserve(count);
+  for (std::size_t p : picks) monsters.emplace_back(Monster::orc, names[p], roars[p], 10);
+  std::cout << "interned monsters: created in " << t.elapsed() << " s, about "
+            << (count * sizeof(Monster) + pool.characters()) / (1024 * 1024) << " MB\n";
+
+  // count the monsters with the same name as the previous one
+  t.reset();
+  std::size_t equalStrings{ 0 };
+  for (std::size_t i{ 1 }; i < count; ++i) equalStrings += stringMonsters[i].name == stringMonsters[i - 1].name;
+  std::cout << "std::string equality: " << t.elapsed() << " s\n";
+
+  t.reset();
+  std::size_t equalSymbols{ 0 };
+  for (std::size_t i{ 1 }; i < count; ++i) {
+    equalSymbols += monsters[i].getNameSymbol() == monsters[i - 1].getNameSymbol();
+  }
+  std::cout << "Symbol equality: " << t.elapsed() << " s\n";
+  assert(equalStrings == equalSymbols);
+
+  return 0;
+}
@@ -0,0 +1,111 @@
+#include "../libs/random/Random.h"
+#include "../libs/simd/MinMax.h"
+#include "../libs/threads/ThreadPool.h"
+#include "../libs/timer/Timer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Build with -march=native (or -mavx2) for the AVX2 kernels, -msse4.2 for the SSE ones; without either the scalar loop
+// is used.
+
+// findMinMax() from 16.x_3, two branches per element
+template<typename T> std::pair<std::size_t, std::size_t> findMinMax(const std::vector<T>& v)
+{
+  std::size_t min{ 0 };
+  std::size_t max{ 0 };
+  for (std::size_t i{ 1 }; i < std::size(v); ++i) {
+    if (v[i] > v[max]) { max = i; }
+    if (v[i] < v[min]) { min = i; }
+  }
+  return { min, max };
+}
+
+template<typename T> std::vector<T> makeValues(std::size_t count)
+{
+  std::vector<T> values(count);
+  for (auto& v : values) {
+    if constexpr (std::is_floating_point_v<T>) {
+      v = static_cast<T>(Random::get(-1'000'000'000, 1'000'000'000)) / T{ 1000 };
+    } else {
+      v = Random::get<T>(-1'000'000'000, 1'000'000'000);
+    }
+  }
+  return values;
+}
+
+// Compares with the 16.x_3 loop on sizes around the vector widths, with duplicates of the extremes
+template<typename T> void check()
+{
+  for (std::size_t n{ 1 }; n < 70; ++n) {
+    std::vector<T> values{ makeValues<T>(n) };
+    for (std::size_t i{ 0 }; i < n / 3; ++i) values[Random::get<std::size_t>(0, n - 1)] = values[0];
+    auto [minIndex, maxIndex]{ findMinMax(values) };
+    MinMax::Result<T> result{ MinMax::findMinMax(std::span<const T>{ values }) };
+    assert(result.minIndex == minIndex && result.maxIndex == maxIndex);
+    assert(result.min == values[minIndex] && result.max == values[maxIndex]);
+  }
+}
+
+template<typename T> void benchmark(const char* name, std::size_t count)
+{
+  std::vector<T> values{ makeValues<T>(count) };
+  // the extremes appear twice, the first ones must be found
+  values[count / 3] = values[count - 1] = T{ -2'000'000 };
+  values[count / 4] = values[count / 2] = T{ 2'000'000 };
+
+  std::cout << name << ", " << count * sizeof(T) / (1024 * 1024) << " MB:\n";
+  Timer t{};
+  auto [minIndex, maxIndex]{ findMinMax(values) };
+  std::cout << "  16.x_3 findMinMax: " << t.elapsed() * 1000 << " ms\n";
+
+  t.reset();
+  auto [minIt, maxIt]{ std::minmax_element(values.begin(), values.end()) };
+  std::cout << "  std::minmax_element: " << t.elapsed() * 1000 << " ms\n";
+  assert(*minIt == values[minIndex] && *maxIt == values[maxIndex]); // it finds the last maximum, not the first
+
+  t.reset();
+  MinMax::Result<T> simd{ MinMax::findMinMax(std::span<const T>{ values }) };
+  std::cout << "  MinMax::findMinMax: " << t.elapsed() * 1000 << " ms\n";
+  assert(simd.minIndex == minIndex && simd.maxIndex == maxIndex);
+
+  t.reset();
+  MinMax::Result<T> parallel{ MinMax::findMinMax(std::span<const T>{ values }, ThreadPool::global()) };
+  std::cout << "  MinMax::findMinMax on " << ThreadPool::global().size() << " threads: " << t.elapsed() * 1000
+            << " ms\n";
+  assert(parallel.minIndex == minIndex && parallel.maxIndex == maxIndex);
+}
+
+int main()
+{
+  std::vector<int> v1{ 3, 8, 2, 5, 7, 8, 3 };
+  MinMax::Result<int> m1{ MinMax::findMinMax(std::span<const int>{ v1 }) };
+  std::cout << "The min element has index " << m1.minIndex << " and value " << m1.min << '\n';
+  std::cout << "The max element has index " << m1.maxIndex << " and value " << m1.max << '\n';
+  assert(m1.minIndex == 2 && m1.maxIndex == 1);
+
+  check<std::int32_t>();
+  check<std::int64_t>();
+  check<float>();
+  check<double>();
+
+  // the pool splits the input, the first occurrence must still win across the blocks
+  std::vector<std::int32_t> equal(5'000'000, 7);
+  ThreadPool pool{ 4 };
+  MinMax::Result<std::int32_t> allEqual{ MinMax::findMinMax(std::span<const std::int32_t>{ equal }, pool) };
+  assert(allEqual.minIndex == 0 && allEqual.maxIndex == 0);
+
+  constexpr std::size_t count{ 32'000'000 };
+  benchmark<std::int32_t>("int32", count);
+  benchmark<std::int64_t>("int64", count);
+  benchmark<float>("float", count);
+  benchmark<double>("double", count);
+
+  return 0;
+}
@@ -10,7 +10,7 @@ void fizzbuzz(int n, const std::vector<int>& divisors, const std::vector<std::st
   for (int i{ 1 }; i <= n; ++i) {
     bool printed{ false };
     for (std::size_t j{ 0 }; j < divisors.size(); ++j) {
-      if (i % divisors[j]) {
+      if (i % divisors[j] == 0) {
         std::cout << words[j];
         printed = true;
       }
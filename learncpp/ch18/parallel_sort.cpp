@@ -0,0 +1,129 @@
+#include "../libs/random/Random.h"
+#include "../libs/sort/ParallelSort.h"
+#include "../libs/threads/ThreadPool.h"
+#include "../libs/timer/Timer.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib> // for std::strtoull
+#include <functional> // for std::greater
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Car from 21.7_2 with a year, so there are records with equal make and model
+class Car
+{
+public:
+  Car(std::string_view make, std::string_view model, int year) : m_make{ make }, m_model{ model }, m_year{ year } {}
+
+  friend bool operator==(const Car& c1, const Car& c2) = default;
+
+  friend bool operator<(const Car& c1, const Car& c2)
+  {
+    return std::tie(c1.m_make, c1.m_model, c1.m_year) < std::tie(c2.m_make, c2.m_model, c2.m_year);
+  }
+
+private:
+  std::string m_make{};
+  std::string m_model{};
+  int m_year{};
+};
+
+std::vector<Car> makeCars(std::size_t count)
+{
+  constexpr std::string_view makes[]{ "Toyota", "Honda", "Ford", "Volkswagen", "Hyundai", "Mercedes-Benz" };
+  constexpr std::string_view models[]{ "Corolla", "Accord", "Camry", "Civic", "Focus", "Golf", "i30", "Model S" };
+  std::vector<Car> cars{};
+  cars.reserve(count);
+  for (std::size_t i{ 0 }; i < count; ++i) {
+    cars.emplace_back(makes[Random::get<std::size_t>(0, std::size(makes) - 1)],
+      models[Random::get<std::size_t>(0, std::size(models) - 1)], Random::get(1990, 2025));
+  }
+  return cars;
+}
+
+// Usage: parallel_sort [element count], the default is 10M ints
+int main(int argc, char* argv[])
+{
+  // small inputs are sorted on the calling thread, large ones in parallel, both must match std::sort
+  for (std::size_t n : { 0uz, 1uz, 1000uz, 100'000uz, 1'000'000uz }) {
+    std::vector<int> values(n);
+    for (auto& v : values) v = Random::get(-1'000'000, 1'000'000);
+    std::vector<int> expected{ values };
+    std::sort(expected.begin(), expected.end());
+    std::vector<int> parallel{ values };
+    Sort::sort(Sort::par, parallel.begin(), parallel.end());
+    assert(parallel == expected);
+    Sort::sort(Sort::seq, values.begin(), values.end());
+    assert(values == expected);
+  }
+
+  // a pool of our own, a comparator, and all-equal and sorted inputs
+  ThreadPool pool{ 4 };
+  std::vector<int> equal(200'000, 7);
+  Sort::sort(Sort::ParallelPolicy{ &pool }, equal.begin(), equal.end());
+  std::vector<int> descending(200'000);
+  for (std::size_t i{ 0 }; i < descending.size(); ++i) descending[i] = static_cast<int>(i);
+  Sort::sort(Sort::ParallelPolicy{ &pool }, descending.begin(), descending.end(), std::greater<>{});
+  assert(std::is_sorted(descending.begin(), descending.end(), std::greater<>{}));
+
+  // a throwing task doesn't leave the others running: every task has finished when the first exception arrives
+  std::atomic<int> finished{ 0 };
+  std::string message{};
+  try {
+    Sort::detail::parallelFor(pool, 16, [&finished](std::size_t i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+      ++finished;
+      if (i % 5 == 3) throw std::runtime_error{ std::to_string(i) };
+    });
+  } catch (const std::runtime_error& e) {
+    message = e.what();
+  }
+  assert(finished == 16 && message == "3");
+
+  // records without a default constructor
+  std::vector<Car> cars{ makeCars(500'000) };
+  std::vector<Car> expectedCars{ cars };
+  Timer t{};
+  std::sort(expectedCars.begin(), expectedCars.end());
+  std::cout << "std::sort of " << cars.size() << " cars: " << t.elapsed() << " s\n";
+  t.reset();
+  Sort::sort(Sort::par, cars.begin(), cars.end());
+  std::cout << "Sort::par of " << cars.size() << " cars: " << t.elapsed() << " s\n";
+  assert(cars == expectedCars);
+
+  std::size_t count{ argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 10'000'000 };
+  std::vector<int> input(count);
+  for (auto& v : input) v = Random::get(0, 1'000'000'000);
+
+  std::vector<int> values{ input };
+  t.reset();
+  std::sort(values.begin(), values.end());
+  double baseline{ t.elapsed() };
+  std::cout << "\nstd::sort of " << count << " ints: " << baseline << " s\n";
+
+  // 1, 2, 4, ... threads, and all the cores
+  unsigned cores{ std::max(1u, std::thread::hardware_concurrency()) };
+  std::vector<unsigned> threadCounts{};
+  for (unsigned threads{ 1 }; threads < cores; threads *= 2) threadCounts.push_back(threads);
+  threadCounts.push_back(cores);
+
+  for (unsigned threads : threadCounts) {
+    ThreadPool threadPool{ threads };
+    values = input;
+    t.reset();
+    Sort::sort(Sort::ParallelPolicy{ &threadPool }, values.begin(), values.end());
+    double elapsed{ t.elapsed() };
+    assert(std::is_sorted(values.begin(), values.end()));
+    std::cout << threads << " threads: " << elapsed << " s (" << baseline / elapsed << "x std::sort)\n";
+  }
+
+  return 0;
+}
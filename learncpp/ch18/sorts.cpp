@@ -0,0 +1,173 @@
+#include "../libs/random/Random.h"
+#include "../libs/sort/Sort.h"
+#include "../libs/timer/Timer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib> // for std::strtoull
+#include <functional> // for std::greater
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <utility>
+#include <vector>
+
+// The early-terminating bubble sort from 18.1_3
+template<typename T> void bubbleSort(std::span<T> array)
+{
+  std::size_t length{ array.size() };
+  for (std::size_t i{ 0 }; i + 1 < length; ++i) {
+    bool swapped{ false };
+    for (std::size_t j{ 0 }; j + i + 1 < length; ++j) {
+      if (array[j] > array[j + 1]) {
+        std::swap(array[j], array[j + 1]);
+        swapped = true;
+      }
+    }
+    if (!swapped) break;
+  }
+}
+
+enum class Distribution {
+  random,
+  sorted,
+  reversed,
+  nearlySorted, // sorted, then 1% of the elements swapped with random others
+  fewUnique, // 16 distinct values
+  maxDistributions, // must be last
+};
+
+constexpr const char* distributionNames[]{ "random", "sorted", "reversed", "nearly sorted", "few unique" };
+
+template<typename T> std::vector<T> makeInput(Distribution distribution, std::size_t n)
+{
+  std::vector<T> values(n);
+  if (distribution == Distribution::fewUnique) {
+    for (auto& v : values) v = Random::get<T>(0, 15);
+    return values;
+  }
+
+  for (auto& v : values) v = Random::get<T>(0, 1'000'000'000);
+  if (distribution == Distribution::random) return values;
+
+  std::sort(values.begin(), values.end());
+  if (distribution == Distribution::reversed) std::reverse(values.begin(), values.end());
+  if (distribution == Distribution::nearlySorted && n > 1) {
+    for (std::size_t i{ 0 }; i < n / 100 + 1; ++i) {
+      std::swap(values[Random::get<std::size_t>(0, n - 1)], values[Random::get<std::size_t>(0, n - 1)]);
+    }
+  }
+  return values;
+}
+
+struct Algorithm
+{
+  const char* name{};
+  void (*sort)(std::span<int>){};
+  std::size_t maxSize{}; // larger inputs are skipped
+};
+
+constexpr std::size_t unlimited{ static_cast<std::size_t>(-1) };
+
+const Algorithm algorithms[]{
+  { "bubble", bubbleSort<int>, 1024 },
+  { "network", Sort::networkSort<int>, Sort::maxNetworkSize },
+  { "std::sort", [](std::span<int> s) { std::sort(s.begin(), s.end()); }, unlimited },
+  { "stable_sort", [](std::span<int> s) { std::stable_sort(s.begin(), s.end()); }, unlimited },
+  { "pdqsort", [](std::span<int> s) { Sort::pdqsort(s); }, unlimited },
+  { "radix", Sort::radixSort<int>, unlimited },
+};
+
+// Nanoseconds per element to sort copies of the input. Small inputs are sorted many times (in different copies, so
+// every round sorts unsorted data) until about a million elements have been sorted.
+double measure(const Algorithm& algorithm, const std::vector<int>& input, const std::vector<int>& expected)
+{
+  std::size_t n{ input.size() };
+  std::size_t rounds{ std::max<std::size_t>(1, (1uz << 20) / n) };
+  std::vector<int> work{};
+  work.reserve(n * rounds);
+  for (std::size_t r{ 0 }; r < rounds; ++r) work.insert(work.end(), input.begin(), input.end());
+
+  std::span<int> all{ work };
+  Timer t{};
+  for (std::size_t r{ 0 }; r < rounds; ++r) algorithm.sort(all.subspan(r * n, n));
+  double elapsed{ t.elapsed() };
+
+  assert(std::equal(expected.begin(), expected.end(), work.begin()) && "sort produced a wrong result");
+  return elapsed / static_cast<double>(n * rounds) * 1e9;
+}
+
+template<typename T> void checkSorts(std::size_t n)
+{
+  for (int d{ 0 }; d < static_cast<int>(Distribution::maxDistributions); ++d) {
+    std::vector<T> values{ makeInput<T>(static_cast<Distribution>(d), n) };
+    std::vector<T> expected{ values };
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<T> pdq{ values };
+    Sort::pdqsort(std::span{ pdq });
+    assert(pdq == expected);
+    std::vector<T> radix{ values };
+    Sort::radixSort(std::span{ radix });
+    assert(radix == expected);
+    if (n <= Sort::maxNetworkSize) {
+      std::vector<T> network{ values };
+      Sort::networkSort(std::span{ network });
+      assert(network == expected);
+    }
+  }
+}
+
+// Usage: sorts [max size], e.g. `sorts 100000000` includes the 100M runs (about 1.2 GB of memory)
+int main(int argc, char* argv[])
+{
+  int array[]{ 6, 3, 2, 9, 7, 1, 5, 4, 8 };
+  Sort::networkSort(std::span<int>{ array });
+  assert(std::is_sorted(std::begin(array), std::end(array)));
+
+  // negative numbers, 64-bit keys and a descending comparator
+  std::vector<std::int64_t> signedValues{ 5, -3, 1LL << 40, -(1LL << 50), 0, 7, -3 };
+  Sort::radixSort(std::span{ signedValues });
+  assert(std::is_sorted(signedValues.begin(), signedValues.end()));
+  std::vector<int> descending{ makeInput<int>(Distribution::random, 1000) };
+  Sort::pdqsort(descending.begin(), descending.end(), std::greater<>{});
+  assert(std::is_sorted(descending.begin(), descending.end(), std::greater<>{}));
+
+  for (std::size_t n{ 0 }; n <= Sort::maxNetworkSize; ++n) checkSorts<int>(n);
+  for (std::size_t n : { 100uz, 1000uz, 100'000uz }) {
+    checkSorts<int>(n);
+    checkSorts<std::uint64_t>(n);
+  }
+
+  std::size_t maxSize{ argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 10'000'000 };
+  constexpr std::size_t sizes[]{ 16, 1'000, 100'000, 1'000'000, 10'000'000, 100'000'000 };
+
+  std::cout << "ns per element\n";
+  for (int d{ 0 }; d < static_cast<int>(Distribution::maxDistributions); ++d) {
+    std::cout << '\n' << distributionNames[d] << ":\n" << std::setw(12) << "size";
+    for (const auto& algorithm : algorithms) std::cout << std::setw(13) << algorithm.name;
+    std::cout << '\n';
+
+    for (std::size_t n : sizes) {
+      if (n > maxSize) break;
+      std::vector<int> input{ makeInput<int>(static_cast<Distribution>(d), n) };
+      std::vector<int> expected{ input };
+      std::sort(expected.begin(), expected.end());
+
+      std::cout << std::setw(12) << n;
+      for (const auto& algorithm : algorithms) {
+        if (n > algorithm.maxSize) {
+          std::cout << std::setw(13) << '-';
+        } else {
+          std::cout << std::setw(13) << std::setprecision(3) << measure(algorithm, input, expected);
+        }
+        std::cout.flush();
+      }
+      std::cout << '\n';
+    }
+  }
+
+  return 0;
+}
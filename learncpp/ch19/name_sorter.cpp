@@ -0,0 +1,127 @@
+#include "../libs/io/LineFile.h"
+#include "../libs/random/Random.h"
+#include "../libs/sort/StringSort.h"
+#include "../libs/timer/Timer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib> // for std::strtoull
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <unistd.h> // for pipe, write, close
+
+// 19.2_1 with the names read from a file: a heap-allocated std::string and a std::getline call per name
+void sortWithStrings(const std::string& inputPath, const std::string& outputPath)
+{
+  Timer t{};
+  std::ifstream input{ inputPath };
+  std::vector<std::string> names{};
+  for (std::string name{}; std::getline(input, name);) names.push_back(name);
+  std::cout << "  read: " << t.elapsed() << " s\n";
+
+  t.reset();
+  std::sort(names.begin(), names.end());
+  std::cout << "  sort: " << t.elapsed() << " s\n";
+
+  t.reset();
+  std::ofstream output{ outputPath };
+  for (const auto& name : names) output << name << '\n';
+  output.close();
+  std::cout << "  write: " << t.elapsed() << " s\n";
+}
+
+// One mapping, views into it, one write
+void sortWithViews(const std::string& inputPath, const std::string& outputPath)
+{
+  Timer t{};
+  LineFile::MappedFile input{ inputPath };
+  std::vector<std::string_view> names{ LineFile::splitLines(input.contents()) };
+  std::cout << "  read: " << t.elapsed() << " s\n";
+
+  t.reset();
+  Sort::sortStrings(names);
+  std::cout << "  sort: " << t.elapsed() << " s\n";
+
+  t.reset();
+  LineFile::writeLines(outputPath, names);
+  std::cout << "  write: " << t.elapsed() << " s\n";
+}
+
+std::string makeName()
+{
+  constexpr std::string_view syllables[]{ "an", "bel", "cor", "dra", "el", "fin", "gar", "hal", "is", "jo" };
+  std::string name{};
+  int length{ Random::get(2, 6) };
+  for (int i{ 0 }; i < length; ++i) name += syllables[Random::get<std::size_t>(0, std::size(syllables) - 1)];
+  name[0] = static_cast<char>(name[0] - 'a' + 'A');
+  return name;
+}
+
+// Usage: name_sorter <input> <output>   sorts the lines of input into output (input can be /dev/stdin, or a pipe)
+//        name_sorter [count]            times both ways of sorting count generated names (10M by default)
+int main(int argc, char* argv[])
+{
+  try {
+    if (argc == 3) {
+      sortWithViews(argv[1], argv[2]);
+      return 0;
+    }
+
+    std::vector<std::string_view> lines{ LineFile::splitLines("Mark\r\nAlex\n\nJohn") };
+    assert((lines == std::vector<std::string_view>{ "Mark", "Alex", "", "John" }));
+    assert(LineFile::splitLines("").empty() && LineFile::splitLines("a\n").size() == 1);
+
+    // a pipe reports a size of 0 and can't be mapped, it's read until the writer closes it
+    int pipeEnds[2]{};
+    if (::pipe(pipeEnds) < 0) throw std::runtime_error{ "Can't create a pipe" };
+    std::string piped{};
+    for (int i{ 0 }; i < 20'000; ++i) piped += "Name" + std::to_string(i) + '\n';
+    std::thread writer{ [&] {
+      for (std::size_t done{ 0 }; done < piped.size();) {
+        ssize_t count{ ::write(pipeEnds[1], piped.data() + done, piped.size() - done) };
+        if (count > 0) done += static_cast<std::size_t>(count);
+      }
+      ::close(pipeEnds[1]);
+    } };
+    LineFile::MappedFile fromPipe{ "/dev/fd/" + std::to_string(pipeEnds[0]) };
+    writer.join();
+    ::close(pipeEnds[0]);
+    assert(fromPipe.contents() == piped);
+
+    std::size_t count{ argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 10'000'000 };
+    auto directory{ std::filesystem::temp_directory_path() };
+    std::string inputPath{ directory / "names.txt" };
+    std::string stringsPath{ directory / "names_sorted_strings.txt" };
+    std::string viewsPath{ directory / "names_sorted_views.txt" };
+
+    std::vector<std::string> generated(count);
+    for (auto& name : generated) name = makeName();
+    std::vector<std::string_view> generatedViews(generated.begin(), generated.end());
+    LineFile::writeLines(inputPath, generatedViews);
+
+    std::cout << count << " names, std::getline and std::string:\n";
+    sortWithStrings(inputPath, stringsPath);
+    std::cout << count << " names, mapped file and std::string_view:\n";
+    sortWithViews(inputPath, viewsPath);
+
+    LineFile::MappedFile fromStrings{ stringsPath };
+    LineFile::MappedFile fromViews{ viewsPath };
+    assert(fromStrings.contents() == fromViews.contents());
+
+    std::filesystem::remove(inputPath);
+    std::filesystem::remove(stringsPath);
+    std::filesystem::remove(viewsPath);
+  } catch (const std::exception& e) {
+    std::cerr << "Exception occurred: " << e.what() << '\n';
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include "../libs/random/Random.h"
+#include "../libs/sort/StringSort.h"
+#include "../libs/timer/Timer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Car from 21.7_2, with getters for the keys
+class Car
+{
+private:
+  std::string m_make;
+  std::string m_model;
+
+public:
+  Car(std::string_view make, std::string_view model) : m_make{ make }, m_model{ model } {}
+
+  const std::string& getMake() const { return m_make; }
+  const std::string& getModel() const { return m_model; }
+
+  friend bool operator==(const Car& c1, const Car& c2) = default;
+
+  // the operator< from 21.7_2, it compares m_make twice when the makes differ
+  friend bool operator<(const Car& c1, const Car& c2)
+  {
+    if (c1.m_make != c2.m_make) { return c1.m_make < c2.m_make; }
+    return c1.m_model < c2.m_model;
+  }
+
+  friend std::ostream& operator<<(std::ostream& out, const Car& c)
+  {
+    out << '(' << c.m_make << ", " << c.m_model << ')';
+    return out;
+  }
+};
+
+// Names made of syllables share long prefixes, like real names and report keys do
+std::string makeName()
+{
+  constexpr std::string_view syllables[]{ "an", "bel", "cor", "dra", "el", "fin", "gar", "hal", "is", "jo" };
+  std::string name{};
+  int length{ Random::get(2, 6) };
+  for (int i{ 0 }; i < length; ++i) name += syllables[Random::get<std::size_t>(0, std::size(syllables) - 1)];
+  return name;
+}
+
+int main()
+{
+  std::vector<std::string_view> small{ "Mark", "Alex", "John", "", "Alexander", "Al", "Alex", "Zoe", "alex" };
+  Sort::sortStrings(small);
+  assert(std::is_sorted(small.begin(), small.end()));
+  for (auto name : small) std::cout << '"' << name << "\" ";
+  std::cout << '\n';
+
+  // strings that only differ after a zero byte or in length within the same 8 bytes
+  using namespace std::string_view_literals;
+  std::vector<std::string_view> tricky{ "ab\0c"sv, "ab"sv, "ab\0"sv, "abcdefgh"sv, "abcdefghi"sv, "abcdefg"sv,
+    "ab\0\0"sv };
+  std::vector<std::string_view> expectedTricky{ tricky };
+  std::sort(expectedTricky.begin(), expectedTricky.end());
+  Sort::sortStrings(tricky);
+  assert(tricky == expectedTricky);
+
+  std::vector<Car> cars{ { "Toyota", "Corolla" }, { "Honda", "Accord" }, { "Toyota", "Camry" }, { "Honda", "Civic" } };
+  Sort::sortByStringKeys(std::span{ cars }, &Car::getMake, &Car::getModel);
+  for (const auto& car : cars) std::cout << car << '\n';
+  assert(std::is_sorted(cars.begin(), cars.end()));
+
+  constexpr std::size_t count{ 2'000'000 };
+  std::vector<std::string> names(count);
+  for (auto& name : names) name = makeName();
+
+  std::vector<std::string> strings{ names };
+  Timer t{};
+  std::sort(strings.begin(), strings.end());
+  std::cout << "std::sort of " << count << " std::strings: " << t.elapsed() << " s\n";
+
+  std::vector<std::string_view> views(names.begin(), names.end());
+  t.reset();
+  std::sort(views.begin(), views.end());
+  std::cout << "std::sort of std::string_views: " << t.elapsed() << " s\n";
+
+  std::vector<std::string_view> sorted(names.begin(), names.end());
+  t.reset();
+  Sort::sortStrings(sorted);
+  std::cout << "Sort::sortStrings: " << t.elapsed() << " s\n";
+  assert(sorted == views);
+
+  // inputs that are already in order, reversed, or rise then fall, where a poor pivot splits off few strings per step
+  std::vector<std::string_view> organPipe{ views };
+  std::reverse(organPipe.begin() + static_cast<std::ptrdiff_t>(count / 2), organPipe.end());
+  for (auto input : { views, std::vector<std::string_view>(views.rbegin(), views.rend()), organPipe }) {
+    Sort::sortStrings(input);
+    assert(input == views);
+  }
+
+  constexpr std::string_view makes[]{ "Toyota", "Honda", "Ford", "Volkswagen", "Hyundai", "Mercedes-Benz",
+    "Chevrolet" };
+  std::vector<Car> manyCars{};
+  for (std::size_t i{ 0 }; i < count; ++i) {
+    manyCars.emplace_back(makes[Random::get<std::size_t>(0, std::size(makes) - 1)], makeName());
+  }
+  std::vector<Car> expectedCars{ manyCars };
+  t.reset();
+  std::sort(expectedCars.begin(), expectedCars.end());
+  std::cout << "std::sort of " << count << " cars: " << t.elapsed() << " s\n";
+  t.reset();
+  Sort::sortByStringKeys(std::span{ manyCars }, &Car::getMake, &Car::getModel);
+  std::cout << "Sort::sortByStringKeys of cars: " << t.elapsed() << " s\n";
+  assert(manyCars == expectedCars);
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include "../libs/random/Random.h"
+#include "../libs/search/Search.h"
+#include "../libs/timer/Timer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <numeric>
+#include <span>
+#include <vector>
+
+// binarySearch() from 20.x_3: branches on every comparison, and the branch is taken at random
+int binarySearch(const int* array, int target, int min, int max)
+{
+  assert(array);
+  while (min <= max) {
+    int mid{ std::midpoint(min, max) };
+    if (array[mid] == target) {
+      return mid;
+    } else if (array[mid] < target) {
+      min = mid + 1;
+    } else {
+      max = mid - 1;
+    }
+  }
+  return -1;
+}
+
+// Sorted, distinct, with gaps, so about half of the queries are misses
+std::vector<int> makeSorted(std::size_t n)
+{
+  std::vector<int> sorted(n);
+  int value{ 0 };
+  for (auto& v : sorted) v = value += Random::get(1, 3);
+  return sorted;
+}
+
+template<typename Search> void benchmark(const char* name, const std::vector<int>& queries, Search search)
+{
+  Timer t{};
+  long long checksum{ 0 };
+  for (int q : queries) checksum += search(q);
+  std::cout << "  " << name << ": " << t.elapsed() / static_cast<double>(queries.size()) * 1e9 << " ns per lookup"
+            << " (checksum " << checksum << ")\n";
+}
+
+int main()
+{
+  // the test values from 20.x_3
+  constexpr int array[]{ 3, 6, 8, 12, 14, 17, 20, 21, 26, 32, 36, 37, 42, 44, 48 };
+  constexpr int testValues[]{ 0, 3, 12, 13, 22, 26, 43, 44, 49 };
+  constexpr int expectedValues[]{ -1, 0, 3, -1, -1, 8, -1, 13, -1 };
+  for (std::size_t i{ 0 }; i < std::size(testValues); ++i) {
+    assert(Search::binarySearch(array, testValues[i]) == expectedValues[i]);
+  }
+  assert(Search::lowerBound({}, 5) == 0);
+
+  // every structure must agree with std::lower_bound, including on sizes that don't fill the last tree level or node
+  for (std::size_t n : { 1uz, 2uz, 15uz, 16uz, 17uz, 100uz, 1000uz, 4097uz }) {
+    std::vector<int> sorted{ makeSorted(n) };
+    Search::Eytzinger eytzinger{ sorted };
+    Search::STree stree{ sorted };
+    for (int key{ -1 }; key <= sorted.back() + 1; ++key) {
+      auto expected{ static_cast<int>(std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin()) };
+      assert(Search::lowerBound(sorted, key) == expected);
+      assert(eytzinger.lowerBound(key) == expected);
+      assert(stree.lowerBound(key) == expected);
+    }
+  }
+
+  // the batch gives the same answers as one search per key, for any batch length
+  for (std::size_t n : { 0uz, 1uz, 17uz, 1000uz }) {
+    std::vector<int> sorted{ makeSorted(n) };
+    std::vector<int> keys(37);
+    for (auto& k : keys) k = Random::get(-1, n == 0 ? 1 : sorted.back() + 1);
+    std::vector<int> indices(keys.size());
+    Search::binarySearchBatch(sorted, keys, indices);
+    for (std::size_t i{ 0 }; i < keys.size(); ++i) assert(indices[i] == Search::binarySearch(sorted, keys[i]));
+  }
+
+  constexpr std::size_t queryCount{ 2'000'000 };
+  // from 4 KB (fits into L1) to 64 MB (DRAM)
+  for (std::size_t n : { 1uz << 10, 1uz << 14, 1uz << 18, 1uz << 22, 1uz << 24 }) {
+    std::vector<int> sorted{ makeSorted(n) };
+    std::vector<int> queries(queryCount);
+    for (auto& q : queries) q = Random::get(0, sorted.back());
+    Search::Eytzinger eytzinger{ sorted };
+    Search::STree stree{ sorted };
+
+    std::cout << n * sizeof(int) / 1024 << " KB:\n";
+    int last{ static_cast<int>(n) - 1 };
+    benchmark("20.x_3 binarySearch", queries, [&](int q) { return binarySearch(sorted.data(), q, 0, last); });
+    benchmark("std::lower_bound", queries,
+      [&](int q) { return std::lower_bound(sorted.begin(), sorted.end(), q) - sorted.begin(); });
+    benchmark("branchless", queries, [&](int q) { return Search::lowerBound(sorted, q); });
+    benchmark("Eytzinger", queries, [&](int q) { return eytzinger.lowerBound(q); });
+    benchmark("S-tree", queries, [&](int q) { return stree.lowerBound(q); });
+
+    // lookups arrive in batches of a few thousand keys
+    constexpr std::size_t batchSize{ 4096 };
+    std::vector<int> indices(queries.size());
+    Timer t{};
+    for (std::size_t first{ 0 }; first < queries.size(); first += batchSize) {
+      for (std::size_t i{ first }; i < first + batchSize && i < queries.size(); ++i) {
+        indices[i] = Search::binarySearch(sorted, queries[i]);
+      }
+    }
+    std::cout << "  binarySearch per key: " << t.elapsed() / static_cast<double>(queries.size()) * 1e9
+              << " ns per lookup\n";
+
+    std::vector<int> batchIndices(queries.size());
+    t.reset();
+    for (std::size_t first{ 0 }; first < queries.size(); first += batchSize) {
+      std::size_t count{ std::min(batchSize, queries.size() - first) };
+      Search::binarySearchBatch(sorted, std::span{ queries }.subspan(first, count),
+        std::span{ batchIndices }.subspan(first, count));
+    }
+    std::cout << "  binarySearchBatch: " << t.elapsed() / static_cast<double>(queries.size()) * 1e9
+              << " ns per lookup\n";
+    assert(indices == batchIndices);
+  }
+
+  return 0;
+}
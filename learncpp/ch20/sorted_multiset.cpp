@@ -0,0 +1,123 @@
+#include "../libs/random/Random.h"
+#include "../libs/search/SortedMultiset.h"
+#include "../libs/timer/Timer.h"
+#include <algorithm> // std::find, std::min_element, std::shuffle
+#include <cassert>
+#include <cmath> // std::abs
+#include <cstddef>
+#include <cstdlib> // std::strtoull
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using Numbers = std::vector<int>;
+
+// generateNumbers(), findAndRemove() and findClosestNumber() from 20.7_3
+Numbers generateNumbers(int start, int count, int multiplier)
+{
+  Numbers numbers(static_cast<std::size_t>(count));
+  for (int index = 0; index < count; ++index) {
+    numbers[static_cast<std::size_t>(index)] = (start + index) * (start + index) * multiplier;
+  }
+  return numbers;
+}
+
+bool findAndRemove(Numbers& numbers, int guess)
+{
+  auto found{ std::find(numbers.begin(), numbers.end(), guess) };
+  if (found == numbers.end()) return false;
+  numbers.erase(found);
+  return true;
+}
+
+// The distances are computed in long long: a - guess overflows an int for the random numbers of the benchmark
+int findClosestNumber(const Numbers& numbers, int guess)
+{
+  auto distance{ [guess](int a) { return std::abs(static_cast<long long>(a) - guess); } };
+  return *std::min_element(numbers.begin(), numbers.end(), [=](int a, int b) { return distance(a) < distance(b); });
+}
+
+// The squares overflow an int after about 19000 of them, so large games use random numbers instead
+Numbers randomNumbers(std::size_t count)
+{
+  Numbers numbers(count);
+  for (auto& n : numbers) n = Random::get(-1'000'000'000, 1'000'000'000);
+  return numbers;
+}
+
+// A whole game: before every right guess, ask for the number closest to a wrong one like printFailure() does
+template<typename Game> void benchmark(const char* name, const Numbers& numbers, Game game)
+{
+  Numbers guesses{ numbers };
+  std::shuffle(guesses.begin(), guesses.end(), Random::mt);
+  Timer t{};
+  long long checksum{ game(numbers, guesses) };
+  std::cout << "  " << name << ": " << t.elapsed() / static_cast<double>(numbers.size()) * 1e9 << " ns per guess"
+            << " (checksum " << checksum << ")\n";
+}
+
+int main(int argc, char* argv[])
+{
+  SortedMultiset<int> empty{};
+  assert(empty.empty() && !empty.nearest(1) && !empty.eraseOne(1));
+
+  // the closest number must never overflow, even across the whole range of int
+  SortedMultiset<int> extremes{ { std::numeric_limits<int>::min(), std::numeric_limits<int>::max() } };
+  assert(extremes.nearest(-1) == std::numeric_limits<int>::min());
+  assert(extremes.nearest(0) == std::numeric_limits<int>::max());
+  Numbers far{ -1'000'000'000, 1'000'000'000 };
+  assert(findClosestNumber(far, -999'999'999) == -1'000'000'000);
+  assert(findClosestNumber(far, 999'999'999) == 1'000'000'000);
+
+  // play games of 20.7_3 with both, including negative starts that give every square twice
+  for (int game{ 0 }; game < 200; ++game) {
+    Numbers numbers{ generateNumbers(Random::get(-20, 20), Random::get(1, 40), Random::get(2, 6)) };
+    SortedMultiset<int> set{ numbers };
+    while (!numbers.empty()) {
+      int guess{ Random::get(0, 3) == 0 ? Random::get(-100, 10'000)
+                                        : numbers[static_cast<std::size_t>(Random::get(0uz, numbers.size() - 1))] };
+      // equally close numbers may come in another order, so compare the distances
+      int closest{ findClosestNumber(numbers, guess) };
+      assert(std::abs(*set.nearest(guess) - guess) == std::abs(closest - guess));
+      assert(set.contains(guess) == (std::find(numbers.begin(), numbers.end(), guess) != numbers.end()));
+      assert(set.eraseOne(guess) == findAndRemove(numbers, guess));
+      assert(set.size() == numbers.size());
+    }
+    assert(set.empty() && !set.nearest(0));
+  }
+
+  Numbers sorted{ generateNumbers(-3, 7, 2) };
+  SortedMultiset<int> small{ sorted };
+  std::sort(sorted.begin(), sorted.end());
+  assert(small.toVector() == sorted);
+
+  std::size_t maxSize{ argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : 10'000'000 };
+  constexpr std::size_t vectorMaxSize{ 30'000 }; // the vector takes minutes beyond this
+  for (std::size_t size : { 1'000uz, 10'000uz, 30'000uz, 1'000'000uz, 10'000'000uz }) {
+    if (size > maxSize) break;
+    std::cout << size << " numbers\n";
+    Numbers numbers{ randomNumbers(size) };
+
+    if (size <= vectorMaxSize) {
+      benchmark("vector (20.7_3)", numbers, [](Numbers remaining, const Numbers& guesses) {
+        long long checksum{ 0 };
+        for (int guess : guesses) {
+          checksum += findClosestNumber(remaining, guess + 1);
+          findAndRemove(remaining, guess);
+        }
+        return checksum;
+      });
+    }
+    benchmark("SortedMultiset", numbers, [](const Numbers& all, const Numbers& guesses) {
+      SortedMultiset<int> remaining{ all };
+      long long checksum{ 0 };
+      for (int guess : guesses) {
+        checksum += *remaining.nearest(guess + 1);
+        remaining.eraseOne(guess);
+      }
+      return checksum;
+    });
+  }
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "../../libs/hash/ConcurrentStringMap.h"
+#include "../../libs/hash/FlatStringMap.h"
+#include "../../libs/timer/Timer.h"
+#include <algorithm> // for std::max
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// The straightforward alternative: one mutex around one map, every writer waits for every other writer
+class LockedGradeMap
+{
+public:
+  template<typename Function> void update(std::string_view key, Function function)
+  {
+    std::lock_guard lock{ m_mutex };
+    function(m_map[key]);
+  }
+
+  std::size_t size() const
+  {
+    std::lock_guard lock{ m_mutex };
+    return m_map.size();
+  }
+
+private:
+  mutable std::mutex m_mutex{};
+  FlatStringMap<int> m_map{};
+};
+
+// Every thread adds points to students, the sets of students of the threads overlap
+template<typename Map>
+void benchmark(const char* name, Map& map, const std::vector<std::string>& names, unsigned threads)
+{
+  constexpr std::size_t updatesPerThread{ 1'000'000 };
+  Timer t{};
+  std::vector<std::jthread> workers{};
+  for (unsigned w{ 0 }; w < threads; ++w) {
+    workers.emplace_back([&map, &names, w] {
+      for (std::size_t i{ 0 }; i < updatesPerThread; ++i) {
+        map.update(names[(i * 31 + w * 7) % names.size()], [](int& points) { ++points; });
+      }
+    });
+  }
+  workers.clear(); // joins
+  std::cout << name << " with " << threads << " threads: " << t.elapsed() << " s, " << map.size() << " students\n";
+}
+
+int main()
+{
+  ConcurrentStringMap<char> grades{};
+  grades.set("Joe", 'A');
+  grades.set("Frank", 'B');
+  grades.update("Frank", [](char& grade) { ++grade; });
+  std::cout << "Joe has a grade of " << *grades.get("Joe") << '\n';
+  std::cout << "Frank has a grade of " << *grades.get("Frank") << '\n';
+  assert(!grades.get("Susan"));
+
+  grades.merge({ { "Susan", 'C' }, { "Tom", 'D' }, { "Joe", 'B' } });
+  assert(grades.size() == 4 && *grades.get("Joe") == 'B');
+  for (const auto& [name, grade] : grades.snapshot()) std::cout << name << ": " << grade << '\n';
+
+  // concurrent upserts must not lose any update
+  ConcurrentStringMap<int> counters{};
+  {
+    std::vector<std::jthread> workers{};
+    for (int w{ 0 }; w < 8; ++w) {
+      workers.emplace_back([&counters] {
+        for (int i{ 0 }; i < 10'000; ++i) counters.update("student_" + std::to_string(i % 100), [](int& c) { ++c; });
+      });
+    }
+  }
+  std::size_t total{ 0 };
+  counters.forEach([&total](std::string_view, int count) { total += static_cast<std::size_t>(count); });
+  assert(total == 80'000 && counters.size() == 100);
+
+  std::vector<std::string> names{};
+  for (int i{ 0 }; i < 100'000; ++i) names.push_back("student_" + std::to_string(i));
+
+  unsigned hardwareThreads{ std::max(1u, std::thread::hardware_concurrency()) };
+  for (unsigned threads : { 1u, hardwareThreads }) {
+    LockedGradeMap locked{};
+    benchmark("single mutex", locked, names, threads);
+    ConcurrentStringMap<int> sharded{};
+    benchmark("64 shards", sharded, names, threads);
+  }
+
+  return 0;
+}
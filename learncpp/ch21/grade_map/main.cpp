@@ -0,0 +1,120 @@
+#include "../../libs/hash/FlatStringMap.h"
+#include "../../libs/timer/Timer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional> // for std::less
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility> // for std::move
+#include <vector>
+
+struct StudentGrade
+{
+  std::string name{};
+  char grade{};
+};
+
+// GradeMap from quiz 21.9_1, kept for comparison
+class GradeMap
+{
+public:
+  char& operator[](std::string_view name)
+  {
+    auto found = std::find_if(m_map.begin(), m_map.end(), [name](const auto& sg) { return name == sg.name; });
+    if (found != m_map.end()) return found->grade;
+    return m_map.emplace_back(std::string{ name }).grade;
+  }
+
+private:
+  std::vector<StudentGrade> m_map{};
+};
+
+// Lets std::unordered_map look up std::string keys by std::string_view without creating a std::string (C++20)
+struct StringHash
+{
+  using is_transparent = void;
+  std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+std::vector<std::string> makeNames(std::size_t count)
+{
+  std::vector<std::string> names{};
+  names.reserve(count);
+  for (std::size_t i{ 0 }; i < count; ++i) names.push_back("student_" + std::to_string(i * 7919 % 1'000'003));
+  return names;
+}
+
+// Inserts every name, then looks every name up `rounds` times
+template<typename Map> void benchmark(const char* name, const std::vector<std::string>& names, int rounds)
+{
+  Timer t{};
+  Map grades{};
+  for (const auto& n : names) grades[n] = static_cast<char>('A' + n.size() % 5);
+  double insertTime{ t.elapsed() };
+
+  t.reset();
+  std::size_t checksum{ 0 };
+  for (int r{ 0 }; r < rounds; ++r) {
+    for (const auto& n : names) {
+      std::string_view key{ n };
+      // std::map and std::unordered_map only have heterogeneous lookup through find()
+      if constexpr (requires { grades.find(key)->second; })
+        checksum += static_cast<std::size_t>(grades.find(key)->second);
+      else
+        checksum += static_cast<std::size_t>(grades[key]);
+    }
+  }
+  std::cout << name << ": insert " << insertTime << " s, lookup " << t.elapsed() << " s (checksum " << checksum
+            << ")\n";
+}
+
+int main()
+{
+  FlatStringMap<char> grades{};
+  grades["Joe"] = 'A';
+  grades["Frank"] = 'B';
+  std::cout << "Joe has a grade of " << grades["Joe"] << '\n';
+  std::cout << "Frank has a grade of " << grades["Frank"] << '\n';
+  assert(grades.size() == 2 && grades.contains("Joe") && !grades.contains("Susan"));
+  assert(grades.erase("Joe") && !grades.contains("Joe") && grades.size() == 1);
+
+  // grows through many rehashes, erased keys leave tombstones behind
+  FlatStringMap<int> numbers{};
+  for (int i{ 0 }; i < 100'000; ++i) numbers[std::to_string(i)] = i;
+  for (int i{ 0 }; i < 100'000; i += 2) numbers.erase(std::to_string(i));
+  for (int i{ 0 }; i < 100'000; ++i) assert((numbers.find(std::to_string(i)) != nullptr) == (i % 2 == 1));
+  assert(numbers.size() == 50'000);
+
+  // a moved-from map is empty and takes new keys
+  FlatStringMap<int> moved{ std::move(numbers) };
+  assert(moved.size() == 50'000 && numbers.empty() && !numbers.contains("1"));
+  numbers["one"] = 1;
+  assert(numbers.size() == 1 && numbers["one"] == 1);
+  numbers = std::move(moved);
+  assert(numbers.size() == 50'000 && *numbers.find("99999") == 99'999 && moved.empty());
+  moved["two"] = 2;
+  assert(moved.size() == 1 && moved.contains("two"));
+
+  for (std::size_t count : { 1'000uz, 5'000uz }) {
+    std::cout << count << " students:\n";
+    std::vector<std::string> names{ makeNames(count) };
+    benchmark<GradeMap>("  GradeMap (linear find_if)", names, 10);
+    benchmark<std::map<std::string, char, std::less<>>>("  std::map", names, 10);
+    benchmark<std::unordered_map<std::string, char, StringHash, std::equal_to<>>>("  std::unordered_map", names, 10);
+    benchmark<FlatStringMap<char>>("  FlatStringMap", names, 10);
+  }
+
+  // GradeMap is left out from here on, it's quadratic
+  constexpr std::size_t count{ 1'000'000 };
+  std::cout << count << " students:\n";
+  std::vector<std::string> names{ makeNames(count) };
+  benchmark<std::map<std::string, char, std::less<>>>("  std::map", names, 3);
+  benchmark<std::unordered_map<std::string, char, StringHash, std::equal_to<>>>("  std::unordered_map", names, 3);
+  benchmark<FlatStringMap<char>>("  FlatStringMap", names, 3);
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include "../libs/random/Random.h"
+#include "../libs/rational/LinearSystem.h"
+#include "../libs/timer/Timer.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using LinearSystem::Matrix;
+using LinearSystem::Value;
+
+std::vector<Value> multiply(const Matrix& a, const std::vector<Value>& x)
+{
+  std::vector<Value> b(a.size());
+  for (std::size_t i{ 0 }; i < a.size(); ++i) {
+    for (std::size_t j{ 0 }; j < x.size(); ++j) b[i] += a[i][j] * x[j];
+  }
+  return b;
+}
+
+/*
+A = L * U where L is unit lower bidiagonal and U is unit upper bidiagonal with entries in { -1, 0, 1 }, and every row is
+divided by a random denominator. Once the rows are scaled back to integers, all minors of such a matrix are small, so
+with an integer solution everything stays in 64 bits at any size. The solver doesn't know about the structure and does
+the full dense O(n^3) elimination.
+*/
+Matrix makeBoundedMatrix(std::size_t n)
+{
+  std::vector<std::int64_t> lower(n), upper(n);
+  for (std::size_t i{ 0 }; i < n; ++i) {
+    lower[i] = Random::get<std::int64_t>(-1, 1);
+    upper[i] = Random::get<std::int64_t>(-1, 1);
+  }
+
+  Matrix a(n, std::vector<Value>(n));
+  for (std::size_t i{ 0 }; i < n; ++i) {
+    std::int64_t denominator{ Random::get<std::int64_t>(1, 9) };
+    // (L * U)[i][j] = U[i][j] + L[i][i - 1] * U[i - 1][j]
+    a[i][i] = Value{ 1 + (i > 0 ? lower[i] * upper[i - 1] : 0), denominator };
+    if (i + 1 < n) a[i][i + 1] = Value{ upper[i], denominator };
+    if (i > 0) a[i][i - 1] = Value{ lower[i], denominator };
+  }
+  return a;
+}
+
+std::vector<Value> makeSolution(std::size_t n)
+{
+  std::vector<Value> x{};
+  for (std::size_t i{ 0 }; i < n; ++i) x.emplace_back(Random::get<std::int64_t>(-20, 20));
+  return x;
+}
+
+int main()
+{
+  // 2x + y = 1/2, x - 3y = 1/3  =>  x = 11/42, y = -1/42
+  Matrix a{ { Value{ 2 }, Value{ 1 } }, { Value{ 1 }, Value{ -3 } } };
+  std::vector<Value> b{ Value{ 1, 2 }, Value{ 1, 3 } };
+  auto x{ LinearSystem::solve(a, b) };
+  assert(x);
+  std::cout << "x = " << (*x)[0] << ", y = " << (*x)[1] << '\n';
+  assert((*x)[0] == Value(11, 42) && (*x)[1] == Value(-1, 42));
+
+  // Singular systems return std::nullopt
+  Matrix singular{ { Value{ 1 }, Value{ 2 } }, { Value{ 2 }, Value{ 4 } } };
+  assert(!LinearSystem::solve(singular, b));
+
+  // Dense random system, including a zero pivot that needs a row swap
+  Matrix dense{ { Value{ 0 }, Value{ 3, 2 }, Value{ -1 } },
+    { Value{ 4 }, Value{ 1 }, Value{ 2, 3 } },
+    { Value{ -2 }, Value{ 5 }, Value{ 7, 5 } } };
+  std::vector<Value> expected{ Value{ 1, 3 }, Value{ -2 }, Value{ 5, 7 } };
+  auto denseX{ LinearSystem::solve(dense, multiply(dense, expected), LinearSystem::Execution::parallel, 2) };
+  assert(denseX && *denseX == expected);
+
+  // Minors that don't fit into 64 bits are reported instead of producing a wrong answer
+  constexpr std::int64_t big{ std::int64_t{ 1 } << 40 };
+  Matrix huge{ { Value{ big }, Value{ 1 } }, { Value{ 1 }, Value{ big } } };
+  bool overflowed{ false };
+  try {
+    LinearSystem::solve(huge, std::vector<Value>{ Value{ 1 }, Value{ 1 } });
+  } catch (const std::overflow_error& e) {
+    std::cout << "Exception occurred: " << e.what() << '\n';
+    overflowed = true;
+  }
+  assert(overflowed);
+
+  unsigned threads{ std::thread::hardware_concurrency() };
+  std::cout << "Using " << threads << " threads for the parallel mode\n";
+  for (std::size_t n : { 50uz, 100uz, 200uz, 500uz }) {
+    Matrix m{ makeBoundedMatrix(n) };
+    std::vector<Value> solution{ makeSolution(n) };
+    std::vector<Value> rhs{ multiply(m, solution) };
+
+    Timer t{};
+    auto sequential{ LinearSystem::solve(m, rhs) };
+    double sequentialTime{ t.elapsed() };
+    t.reset();
+    auto parallel{ LinearSystem::solve(m, rhs, LinearSystem::Execution::parallel) };
+    double parallelTime{ t.elapsed() };
+
+    assert(sequential && *sequential == solution);
+    assert(parallel && *parallel == solution);
+    std::cout << n << 'x' << n << ": sequential " << sequentialTime << " s, parallel " << parallelTime << " s\n";
+  }
+
+  return 0;
+}
@@ -1,6 +1,16 @@
+#include <algorithm>
 #include <cassert>
+#include <charconv> // for std::from_chars_result, std::to_chars_result
+#include <cctype>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <span>
+#include <sstream>
+#include <string_view>
+#include <system_error> // for std::errc
 
 class FixedPoint2
 {
@@ -31,6 +41,7 @@ public:
   friend bool operator==(const FixedPoint2& fp1, const FixedPoint2& fp2);
   friend FixedPoint2 operator+(const FixedPoint2& fp1, const FixedPoint2& fp2);
   friend std::istream& operator>>(std::istream& is, FixedPoint2& fp);
+  friend std::to_chars_result toChars(char* first, char* last, const FixedPoint2& fp);
 
   friend bool testDecimal(const FixedPoint2& fp);
 
@@ -39,20 +50,152 @@ private:
   std::int8_t m_decimal{};
 };
 
+/*
+fromChars/toChars work like std::from_chars/std::to_chars: they don't allocate, don't depend on locale and don't throw.
+The text is converted straight into the scaled integer (base * 100 + decimal), so there is no round trip through double
+and no precision loss ("5.01" is exactly 501 hundredths, while the double 5.01 is 5.0099999...). Digits after the second
+decimal place are rounded half away from zero, the same way FixedPoint2(double) rounds.
+*/
+std::from_chars_result fromChars(const char* first, const char* last, FixedPoint2& fp)
+{
+  const char* p{ first };
+  bool negative{ false };
+  if (p != last && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  // the range of int16 base is asymmetric: -32768.99 fits, 32768.00 doesn't
+  constexpr std::int32_t maxScaled{ 32767 * 100 + 99 };
+  constexpr std::int32_t maxNegativeScaled{ 32768 * 100 + 99 };
+  const std::int32_t limit{ negative ? maxNegativeScaled : maxScaled };
+  std::int32_t scaled{ 0 };
+  bool overflow{ false };
+  const char* digitsBegin{ p };
+  for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+    scaled = scaled * 10 + (*p - '0') * 100;
+    if (scaled > limit) {
+      overflow = true;
+      scaled = limit; // keep consuming digits, but don't let the accumulator overflow
+    }
+  }
+  bool hasDigits{ p != digitsBegin };
+
+  if (p != last && *p == '.') {
+    ++p;
+    const char* fracBegin{ p };
+    std::int32_t weight{ 10 };
+    for (; p != last && *p >= '0' && *p <= '9'; ++p) {
+      if (weight > 0) {
+        scaled += (*p - '0') * weight;
+        weight /= 10;
+      } else if (p == fracBegin + 2 && *p >= '5') {
+        ++scaled; // the third decimal digit decides rounding, the rest are only consumed
+      }
+    }
+    hasDigits = hasDigits || p != fracBegin;
+  }
+
+  if (!hasDigits) return { first, std::errc::invalid_argument };
+  if (overflow || scaled > limit) return { p, std::errc::result_out_of_range };
+
+  if (negative) scaled = -scaled;
+  fp = FixedPoint2{ static_cast<std::int16_t>(scaled / 100), static_cast<std::int8_t>(scaled % 100) };
+  return { p, std::errc{} };
+}
+
+// Always writes two decimal digits ("1.90", not "1.9"), which is what a fixed-point value actually stores.
+std::to_chars_result toChars(char* first, char* last, const FixedPoint2& fp)
+{
+  std::int32_t scaled{ fp.m_base * 100 + fp.m_decimal };
+  bool negative{ scaled < 0 };
+  std::uint32_t value{ static_cast<std::uint32_t>(negative ? -scaled : scaled) };
+
+  // the longest value is "-32768.99" (9 characters), so format into a local buffer right to left and copy it once
+  char buf[16]{};
+  char* p{ buf + sizeof(buf) };
+  std::uint32_t decimal{ value % 100 };
+  *--p = static_cast<char>('0' + decimal % 10);
+  *--p = static_cast<char>('0' + decimal / 10);
+  *--p = '.';
+  std::uint32_t base{ value / 100 };
+  do {
+    *--p = static_cast<char>('0' + base % 10);
+    base /= 10;
+  } while (base != 0);
+  if (negative) *--p = '-';
+
+  std::ptrdiff_t length{ buf + sizeof(buf) - p };
+  if (last - first < length) return { last, std::errc::value_too_large };
+  std::copy(p, buf + sizeof(buf), first);
+  return { first + length, std::errc{} };
+}
+
 std::ostream& operator<<(std::ostream& os, const FixedPoint2& p)
 {
-  os << static_cast<double>(p);
+  char buf[16]{};
+  auto [end, ec]{ toChars(std::begin(buf), std::end(buf), p) };
+  os.write(buf, end - buf);
   return os;
 }
 
 std::istream& operator>>(std::istream& is, FixedPoint2& fp)
 {
-  double d{};
-  is >> d;
-  fp = d;
+  // collect the token into a stack buffer instead of reading a double (or a std::string, which would allocate)
+  auto isTokenChar{ [](auto c) { return std::isdigit(c) || c == '.' || c == '-' || c == '+'; } };
+  char buf[32]{};
+  std::size_t length{ 0 };
+  is >> std::ws;
+  while (length < std::size(buf)) {
+    auto c{ is.peek() };
+    if (c == std::istream::traits_type::eof() || !isTokenChar(c)) break;
+    buf[length++] = static_cast<char>(is.get());
+  }
+
+  // a token that doesn't fit isn't a valid value, and mustn't be parsed as its first 32 characters
+  if (length == std::size(buf)) {
+    auto next{ is.peek() };
+    if (next != std::istream::traits_type::eof() && isTokenChar(next)) {
+      is.setstate(std::ios_base::failbit);
+      return is;
+    }
+  }
+
+  auto [end, ec]{ fromChars(buf, buf + length, fp) };
+  if (ec != std::errc{} || end != buf + length) is.setstate(std::ios_base::failbit);
   return is;
 }
 
+/*
+Parses one column of a CSV text (fields separated by ',', rows by '\n') into a caller-provided span, so the caller
+decides how the storage is allocated (and can reuse it between batches). Returns the number of rows parsed. Parsing stops
+at the first row whose field is missing or malformed, or when `out` is full; the return value tells where.
+*/
+std::size_t parseCsvColumn(std::string_view csv, std::size_t column, std::span<FixedPoint2> out)
+{
+  std::size_t rows{ 0 };
+  while (!csv.empty() && rows < out.size()) {
+    std::size_t lineEnd{ csv.find('\n') };
+    std::string_view line{ csv.substr(0, lineEnd) };
+    csv.remove_prefix(lineEnd == std::string_view::npos ? csv.size() : lineEnd + 1);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+    for (std::size_t i{ 0 }; i < column; ++i) {
+      std::size_t comma{ line.find(',') };
+      if (comma == std::string_view::npos) return rows;
+      line.remove_prefix(comma + 1);
+    }
+    std::string_view field{ line.substr(0, line.find(',')) };
+    while (!field.empty() && field.front() == ' ') field.remove_prefix(1);
+    while (!field.empty() && field.back() == ' ') field.remove_suffix(1);
+
+    auto [end, ec]{ fromChars(field.data(), field.data() + field.size(), out[rows]) };
+    if (ec != std::errc{} || end != field.data() + field.size()) return rows;
+    ++rows;
+  }
+  return rows;
+}
+
 bool operator==(const FixedPoint2& fp1, const FixedPoint2& fp2)
 {
   return fp1.m_base == fp2.m_base && fp1.m_decimal == fp2.m_decimal;
@@ -121,6 +264,50 @@ int main()
   assert(static_cast<double>(a2) == -0.48);
   assert(static_cast<double>(-a2) == 0.48);
 
+  FixedPoint2 h{};
+  std::string_view text{ "-12.345" };
+  auto [end, ec]{ fromChars(text.data(), text.data() + text.size(), h) };
+  assert(ec == std::errc{} && end == text.data() + text.size());
+  assert(h == FixedPoint2(-12, -35)); // rounded on the third decimal digit
+  text = "5.01";
+  fromChars(text.data(), text.data() + text.size(), h);
+  assert(h == FixedPoint2{ 5.01 });
+  text = ".5";
+  fromChars(text.data(), text.data() + text.size(), h);
+  assert(h == FixedPoint2{ 0.5 });
+  text = "99999";
+  assert(fromChars(text.data(), text.data() + text.size(), h).ec == std::errc::result_out_of_range);
+  text = "abc";
+  assert(fromChars(text.data(), text.data() + text.size(), h).ec == std::errc::invalid_argument);
+  text = "-32768.99"; // the smallest value, which toChars() writes too
+  assert(fromChars(text.data(), text.data() + text.size(), h).ec == std::errc{} && h == FixedPoint2(-32768, -99));
+  text = "32768";
+  assert(fromChars(text.data(), text.data() + text.size(), h).ec == std::errc::result_out_of_range);
+  text = "-32769";
+  assert(fromChars(text.data(), text.data() + text.size(), h).ec == std::errc::result_out_of_range);
+
+  char buf[16]{};
+  auto [bufEnd, bufEc]{ toChars(std::begin(buf), std::end(buf), FixedPoint2{ -0.48 }) };
+  assert(bufEc == std::errc{} && std::string_view(buf, bufEnd) == "-0.48");
+  bufEnd = toChars(std::begin(buf), std::end(buf), FixedPoint2{ 107.0 }).ptr;
+  assert(std::string_view(buf, bufEnd) == "107.00");
+  bufEnd = toChars(std::begin(buf), std::end(buf), FixedPoint2(-32768, -99)).ptr;
+  assert(std::string_view(buf, bufEnd) == "-32768.99");
+
+  std::istringstream tooLong{ "1.0000000000000000000000000000000000000" };
+  tooLong >> h;
+  assert(tooLong.fail());
+  std::istringstream twoValues{ "1.25 -3.5" };
+  FixedPoint2 first{};
+  twoValues >> first >> h;
+  assert(twoValues && first == FixedPoint2{ 1.25 } && h == FixedPoint2{ -3.5 });
+
+  constexpr std::string_view csv{ "id,price\n1,0.75\n2,1.5\r\n3, -2.25\n" };
+  FixedPoint2 prices[8]{};
+  std::size_t rows{ parseCsvColumn(csv.substr(csv.find('\n') + 1), 1, prices) };
+  assert(rows == 3);
+  assert(prices[0] == FixedPoint2{ 0.75 } && prices[1] == FixedPoint2{ 1.5 } && prices[2] == FixedPoint2{ -2.25 });
+
   std::cout << "Enter a number: "; // enter 5.678
   std::cin >> a2;
   std::cout << "You entered: " << a2 << '\n';
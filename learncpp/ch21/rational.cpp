@@ -0,0 +1,171 @@
+#include "../libs/random/Random.h"
+#include "../libs/rational/Rational.h"
+#include "../libs/timer/Timer.h"
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric> // for std::gcd
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+// The Fraction from the quizzes (21.2, 21.4), but with 64-bit members so the benchmark below doesn't overflow
+class Fraction
+{
+public:
+  Fraction(std::int64_t numerator = 0, std::int64_t denominator = 1)
+    : m_numerator{ numerator }, m_denominator{ denominator }
+  {
+    reduce();
+  }
+
+  void reduce()
+  {
+    std::int64_t gcd{ std::gcd(m_numerator, m_denominator) };
+    if (gcd) {
+      m_numerator /= gcd;
+      m_denominator /= gcd;
+    }
+  }
+
+  friend Fraction operator*(const Fraction& f1, const Fraction& f2)
+  {
+    return Fraction{ f1.m_numerator * f2.m_numerator, f1.m_denominator * f2.m_denominator };
+  }
+
+  friend bool operator==(const Fraction& f1, const Fraction& f2)
+  {
+    return f1.m_numerator == f2.m_numerator && f1.m_denominator == f2.m_denominator;
+  }
+
+private:
+  std::int64_t m_numerator{};
+  std::int64_t m_denominator{};
+};
+
+using EagerRational = Rational<std::int64_t>;
+using LazyRational = Rational<std::int64_t, Normalization::lazy>;
+
+// Multiplies every fraction by the next one and compares the product with the first fraction.
+// Returns the number of equal pairs, so the compiler can't throw the work away.
+template<typename F> std::size_t multiplyPipeline(const std::vector<F>& values)
+{
+  std::size_t equal{ 0 };
+  for (std::size_t i{ 0 }; i + 1 < values.size(); ++i) {
+    F product{ values[i] * values[i + 1] };
+    if (product == values[i]) ++equal;
+  }
+  return equal;
+}
+
+// Tries every denominator, the straightforward alternative to Rational::fromDouble()
+EagerRational naiveFromDouble(double x, std::int64_t maxDenominator)
+{
+  std::int64_t bestNumerator{ 0 };
+  std::int64_t bestDenominator{ 1 };
+  double bestError{ std::abs(x) };
+  for (std::int64_t d{ 1 }; d <= maxDenominator; ++d) {
+    auto n{ static_cast<std::int64_t>(std::round(x * static_cast<double>(d))) };
+    double error{ std::abs(x - static_cast<double>(n) / static_cast<double>(d)) };
+    if (error < bestError) {
+      bestError = error;
+      bestNumerator = n;
+      bestDenominator = d;
+    }
+  }
+  return EagerRational{ bestNumerator, bestDenominator };
+}
+
+template<typename F> void benchmark(const char* name, const std::vector<std::int64_t>& numbers)
+{
+  std::vector<F> values{};
+  values.reserve(numbers.size() / 2);
+  for (std::size_t i{ 0 }; i + 1 < numbers.size(); i += 2) values.emplace_back(numbers[i], numbers[i + 1]);
+
+  Timer t{};
+  std::size_t equal{ multiplyPipeline(values) };
+  std::cout << name << ": " << t.elapsed() << " s (" << equal << " equal)\n";
+}
+
+int main()
+{
+  // Everything is constexpr
+  static_assert(binaryGcd(48u, 18u) == 6u);
+  static_assert(EagerRational{ 2, 4 }.numerator() == 1);
+  static_assert(EagerRational{ 1, 2 } + EagerRational{ 1, 3 } == EagerRational{ 5, 6 });
+  static_assert(LazyRational{ 2, 4 } == LazyRational{ 1, 2 });
+  static_assert(EagerRational{ 1, 3 } < EagerRational{ 1, 2 });
+
+  EagerRational r1{ 2, 5 };
+  EagerRational r2{ 3, 8 };
+  std::cout << r1 << " * " << r2 << " = " << r1 * r2 << '\n';
+  std::cout << r1 << " + " << r2 << " = " << r1 + r2 << '\n';
+  std::cout << r1 << " - " << r2 << " = " << r1 - r2 << '\n';
+  std::cout << r1 << " / " << r2 << " = " << r1 / r2 << '\n';
+  assert(EagerRational(0, 6) == EagerRational{});
+  assert(EagerRational(1, -2).denominator() == 2);
+
+  // Lazy values keep the unreduced pair until they're printed
+  LazyRational l{ LazyRational{ 1, 2 } * LazyRational{ 2, 3 } * LazyRational{ 3, 4 } };
+  assert(l.numerator() == 6 && l.denominator() == 24);
+  std::cout << "lazy 1/2 * 2/3 * 3/4 = " << l << '\n';
+
+  // Cross-cancelling keeps the intermediate values small: without it the numerator would be 2^62 * 3
+  constexpr std::int64_t big{ std::int64_t{ 1 } << 62 };
+  assert(EagerRational(big, 3) * EagerRational(3, big) == EagerRational{ 1 });
+
+  // A result that really doesn't fit throws instead of overflowing silently
+  try {
+    EagerRational huge{ EagerRational(big, 3) * EagerRational(big, 5) };
+    std::cout << huge << '\n';
+  } catch (const std::overflow_error& e) {
+    std::cout << "Exception occurred: " << e.what() << '\n';
+  }
+
+  // Subtraction doesn't negate r2 first, which would overflow for the smallest numerator
+  constexpr std::int64_t min{ std::numeric_limits<std::int64_t>::min() };
+  assert(EagerRational{ min } - EagerRational{ min } == EagerRational{});
+  assert(EagerRational{ -1 } - EagerRational{ min } == EagerRational{ std::numeric_limits<std::int64_t>::max() });
+  assert(LazyRational(min, 2) - LazyRational(min, 4) == LazyRational(min / 4));
+  static_assert(EagerRational{ 1, 2 } - EagerRational{ 1, 3 } == EagerRational{ 1, 6 });
+
+  // Best rational approximations with a bounded denominator
+  assert(EagerRational::fromDouble(3.14159265358979, 1000) == EagerRational(355, 113));
+  assert(EagerRational::fromDouble(-0.75, 100) == EagerRational(-3, 4));
+  assert(EagerRational::fromDouble(0.333333, 10) == EagerRational(1, 3));
+  assert(EagerRational::fromDouble(2.0, 10) == EagerRational{ 2 });
+  std::cout << "pi ~ " << EagerRational::fromDouble(3.14159265358979, 100) << '\n';
+
+  std::vector<double> doubles(100'000);
+  std::uniform_real_distribution<double> distribution{ -1000.0, 1000.0 };
+  for (auto& d : doubles) d = distribution(Random::mt);
+  std::vector<EagerRational> approximations(doubles.size());
+  constexpr std::int64_t maxDenominator{ 10'000 };
+
+  Timer timer{};
+  EagerRational::fromDouble(doubles, maxDenominator, approximations);
+  std::cout << "fromDouble(span): " << timer.elapsed() / static_cast<double>(doubles.size()) * 1e6 << " us per value\n";
+
+  // the naive search is orders of magnitude slower, so only a sample is timed and checked against it
+  constexpr std::size_t sample{ 100 };
+  timer.reset();
+  for (std::size_t i{ 0 }; i < sample; ++i) {
+    EagerRational naive{ naiveFromDouble(doubles[i], maxDenominator) };
+    double naiveError{ std::abs(static_cast<double>(naive) - doubles[i]) };
+    assert(std::abs(static_cast<double>(approximations[i]) - doubles[i]) <= naiveError);
+  }
+  std::cout << "naive search: " << timer.elapsed() / sample * 1e6 << " us per value\n";
+
+  constexpr std::size_t count{ 2'000'000 };
+  std::vector<std::int64_t> numbers(count * 2);
+  for (auto& n : numbers) n = Random::get<std::int64_t>(1, 1'000'000);
+
+  benchmark<Fraction>("std::gcd Fraction", numbers);
+  benchmark<EagerRational>("eager Rational", numbers);
+  benchmark<LazyRational>("lazy Rational", numbers);
+
+  return 0;
+}
@@ -0,0 +1,246 @@
+#include "../libs/timer/Timer.h"
+#include <algorithm> // for std::copy_n, std::fill_n
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <utility> // for std::swap
+#include <vector>
+
+/*
+IntArray from 21.x_3 and init_list.cpp, grown into something usable in hot paths:
+- move constructor and move assignment, so returning an IntArray by value or assigning a temporary only swaps pointers
+  instead of doing an O(n) deep copy;
+- capacity separate from length, so push_back() is amortized O(1) (capacity grows by a configurable factor) and
+  assignments reuse the existing buffer when it's large enough;
+- storage is allocated with `new int[n]` (default-initialized, i.e. left uninitialized for int) instead of
+  `new int[n]{}`, since every element is written before it's read anyway. Only resize() zeroes the new elements, like
+  std::vector does.
+*/
+class IntArray
+{
+public:
+  IntArray() = default;
+
+  explicit IntArray(int length) : m_length{ length }, m_capacity{ length }, m_data{ allocate(length) }
+  {
+    assert(length >= 0);
+    std::fill_n(m_data, m_length, 0);
+  }
+
+  IntArray(std::initializer_list<int> list) : IntArray() { *this = list; }
+
+  IntArray(const IntArray& arr)
+    : m_length{ arr.m_length }, m_capacity{ arr.m_length }, m_data{ allocate(arr.m_length) },
+      m_growthFactor{ arr.m_growthFactor }
+  {
+    std::copy_n(arr.m_data, arr.m_length, m_data);
+  }
+
+  IntArray(IntArray&& arr) noexcept { swap(*this, arr); }
+
+  ~IntArray() { delete[] m_data; }
+
+  friend void swap(IntArray& a, IntArray& b) noexcept
+  {
+    std::swap(a.m_length, b.m_length);
+    std::swap(a.m_capacity, b.m_capacity);
+    std::swap(a.m_data, b.m_data);
+    std::swap(a.m_growthFactor, b.m_growthFactor);
+  }
+
+  IntArray& operator=(const IntArray& arr)
+  {
+    if (&arr == this) return *this;
+    assign(arr.m_data, arr.m_length);
+    m_growthFactor = arr.m_growthFactor;
+    return *this;
+  }
+
+  IntArray& operator=(IntArray&& arr) noexcept
+  {
+    // the old buffer ends up in arr and is released when arr is destroyed
+    swap(*this, arr);
+    return *this;
+  }
+
+  IntArray& operator=(std::initializer_list<int> list)
+  {
+    assign(list.begin(), static_cast<int>(list.size()));
+    return *this;
+  }
+
+  int& operator[](int index)
+  {
+    assert(index >= 0 && index < m_length);
+    return m_data[index];
+  }
+
+  int operator[](int index) const
+  {
+    assert(index >= 0 && index < m_length);
+    return m_data[index];
+  }
+
+  int getLength() const { return m_length; }
+  int getCapacity() const { return m_capacity; }
+  int* data() { return m_data; }
+  const int* data() const { return m_data; }
+
+  // Capacity is multiplied by this factor when push_back() runs out of space
+  void setGrowthFactor(double factor)
+  {
+    assert(factor > 1.0 && "IntArray::setGrowthFactor(): factor must be greater than 1");
+    m_growthFactor = factor;
+  }
+
+  void reserve(int capacity)
+  {
+    if (capacity <= m_capacity) return;
+    int* data{ allocate(capacity) };
+    std::copy_n(m_data, m_length, data);
+    delete[] m_data;
+    m_data = data;
+    m_capacity = capacity;
+  }
+
+  void resize(int length)
+  {
+    assert(length >= 0);
+    reserve(length);
+    if (length > m_length) std::fill_n(m_data + m_length, length - m_length, 0);
+    m_length = length;
+  }
+
+  void push_back(int value)
+  {
+    if (m_length == m_capacity) {
+      constexpr int maxCapacity{ std::numeric_limits<int>::max() };
+      assert(m_capacity < maxCapacity && "IntArray::push_back(): the array is full");
+      // converting a double that's out of range to int is undefined, so the product is clamped first
+      double product{ m_capacity * m_growthFactor };
+      int grown{ product < maxCapacity ? static_cast<int>(product) : maxCapacity };
+      reserve(grown > m_capacity ? grown : m_capacity + 1);
+    }
+    m_data[m_length++] = value;
+  }
+
+  void clear() { m_length = 0; }
+
+  friend std::ostream& operator<<(std::ostream& os, const IntArray& arr)
+  {
+    for (int i{ 0 }; i < arr.m_length; ++i) os << arr.m_data[i] << ' ';
+    return os;
+  }
+
+private:
+  int m_length{ 0 };
+  int m_capacity{ 0 };
+  int* m_data{ nullptr };
+  double m_growthFactor{ 2.0 };
+
+  // new int[n] without braces default-initializes, so the memory isn't zeroed
+  static int* allocate(int capacity) { return capacity > 0 ? new int[static_cast<std::size_t>(capacity)] : nullptr; }
+
+  // Replaces the contents, the buffer is reused if it's large enough
+  void assign(const int* source, int length)
+  {
+    if (length > m_capacity) {
+      int* data{ allocate(length) };
+      delete[] m_data;
+      m_data = data;
+      m_capacity = length;
+    }
+    std::copy_n(source, length, m_data);
+    m_length = length;
+  }
+};
+
+IntArray fillArray()
+{
+  IntArray a{ 5, 8, 2, 3, 6 };
+  return a; // moved (or elided), never deep copied
+}
+
+IntArray makeIntArray(int count)
+{
+  IntArray a{};
+  for (int i{ 0 }; i < count; ++i) a.push_back(i);
+  return a;
+}
+
+std::vector<int> makeVector(int count)
+{
+  std::vector<int> v{};
+  for (int i{ 0 }; i < count; ++i) v.push_back(i);
+  return v;
+}
+
+int main()
+{
+  IntArray a{ fillArray() };
+  std::cout << a << '\n';
+
+  IntArray b(1);
+  b = a; // deep copy
+  a[4] = 7;
+  std::cout << b << '\n';
+
+  IntArray c{ std::move(a) }; // no copy, a is left empty
+  assert(a.getLength() == 0 && c[4] == 7);
+
+  c = { 1, 2, 3 }; // fits into the existing buffer, no reallocation
+  assert(c.getLength() == 3 && c.getCapacity() == 5);
+
+  c.resize(6);
+  assert(c[5] == 0);
+  c.setGrowthFactor(1.5);
+  c.push_back(4);
+  assert(c.getLength() == 7 && c.getCapacity() == 9);
+  IntArray d{ c }; // copies keep the growth factor
+  d.push_back(5);
+  assert(d.getLength() == 8 && d.getCapacity() == 10);
+  b = c;
+  b.push_back(5);
+  assert(b.getLength() == 8 && b.getCapacity() == 10);
+  std::cout << c << '\n';
+
+  constexpr int count{ 10'000'000 };
+  constexpr int rounds{ 10 };
+  long long checksum{ 0 };
+
+  Timer t{};
+  for (int r{ 0 }; r < rounds; ++r) {
+    IntArray arr{ makeIntArray(count) };
+    checksum += arr[count - 1];
+  }
+  std::cout << "IntArray push_back: " << t.elapsed() << " s\n";
+
+  t.reset();
+  for (int r{ 0 }; r < rounds; ++r) {
+    std::vector<int> v{ makeVector(count) };
+    checksum += v[count - 1];
+  }
+  std::cout << "std::vector push_back: " << t.elapsed() << " s\n";
+
+  t.reset();
+  for (int r{ 0 }; r < rounds; ++r) {
+    IntArray arr{};
+    arr.resize(count);
+    checksum += arr[count - 1];
+  }
+  std::cout << "IntArray resize: " << t.elapsed() << " s\n";
+
+  t.reset();
+  for (int r{ 0 }; r < rounds; ++r) {
+    std::vector<int> v{};
+    v.resize(count);
+    checksum += v[count - 1];
+  }
+  std::cout << "std::vector resize: " << t.elapsed() << " s\n";
+
+  std::cout << "(checksum " << checksum << ")\n";
+
+  return 0;
+}
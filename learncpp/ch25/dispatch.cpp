@@ -0,0 +1,190 @@
+#include "../libs/poly/FastVisit.h"
+#include "../libs/random/Random.h"
+#include "../libs/timer/Timer.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/*
+Ways to call the right function for each of millions of events of a handful (or a few dozen) of types:
+- virtual functions through std::unique_ptr<EventBase>, like Animal::speak() in ch25;
+- std::visit on a std::variant, like the overloads visitor of tour_of_cpp 15.4.1;
+- a table of function pointers indexed by variant::index(), which is how libraries implement std::visit in general;
+- Poly::fastVisit(), a switch on variant::index() for up to 16 types, std::visit for more;
+- type erasure by hand: every event holds its data and a pointer to a table of functions for its type.
+Events are stored grouped by type (every call goes where the previous one did) or shuffled (the branch predictor can't
+guess the target).
+*/
+
+// The event types differ in what they do, so the compiler can't turn dispatching into a table lookup
+template<std::size_t I> struct Event
+{
+  unsigned value{};
+
+  unsigned handle(unsigned total) const
+  {
+    if constexpr (I % 4 == 0) return total + value + I;
+    if constexpr (I % 4 == 1) return total ^ (value * I);
+    if constexpr (I % 4 == 2) return total - (value >> (I % 8));
+    if constexpr (I % 4 == 3) return total * 3 + value;
+  }
+};
+
+struct EventBase
+{
+  virtual unsigned handle(unsigned total) const = 0;
+  virtual ~EventBase() = default;
+};
+
+template<std::size_t I> struct VirtualEvent final : EventBase
+{
+  explicit VirtualEvent(Event<I> e) : event{ e } {}
+  unsigned handle(unsigned total) const override { return event.handle(total); }
+  Event<I> event{};
+};
+
+template<std::size_t... Is> std::variant<Event<Is>...> variantOf(std::index_sequence<Is...>);
+template<std::size_t N> using EventVariant = decltype(variantOf(std::make_index_sequence<N>{}));
+
+struct ErasedEvent
+{
+  struct Functions
+  {
+    unsigned (*handle)(unsigned value, unsigned total){};
+  };
+
+  const Functions* functions{};
+  unsigned value{};
+
+  template<std::size_t I> static constexpr Functions functionsOf{ [](unsigned value, unsigned total) {
+    return Event<I>{ value }.handle(total);
+  } };
+};
+
+// make(std::integral_constant<std::size_t, index>{}) for an index known only at runtime
+template<std::size_t N, typename Make> auto makeByIndex(std::size_t index, Make make)
+{
+  using Result = decltype(make(std::integral_constant<std::size_t, 0>{}));
+  constexpr auto table{ []<std::size_t... Is>(std::index_sequence<Is...>) {
+    return std::array<Result (*)(Make&), N>{ [](Make& m) { return m(std::integral_constant<std::size_t, Is>{}); }... };
+  }(std::make_index_sequence<N>{}) };
+  return table[index](make);
+}
+
+// The table of function pointers that std::visit builds for large variants
+template<typename Visitor, typename Variant> unsigned tableVisit(Visitor& visitor, const Variant& variant)
+{
+  static constexpr auto table{ []<std::size_t... Is>(std::index_sequence<Is...>) {
+    return std::array<unsigned (*)(Visitor&, const Variant&), sizeof...(Is)>{
+      [](Visitor& v, const Variant& var) { return v(*std::get_if<Is>(&var)); }...
+    };
+  }(std::make_index_sequence<std::variant_size_v<Variant>>{}) };
+  return table[variant.index()](visitor, variant);
+}
+
+template<typename Events, typename Handle> void benchmark(const char* name, const Events& events, Handle handle)
+{
+  Timer t{};
+  unsigned total{ 0 };
+  for (const auto& e : events) total = handle(e, total);
+  std::cout << "    " << name << ": " << t.elapsed() / static_cast<double>(events.size()) * 1e9 << " ns per event"
+            << " (checksum " << total << ")\n";
+}
+
+template<std::size_t N> void benchmarkTypes(std::size_t count)
+{
+  using Variant = EventVariant<N>;
+  for (bool shuffled : { false, true }) {
+    std::vector<std::size_t> kinds(count);
+    for (std::size_t i{ 0 }; i < count; ++i) kinds[i] = i * N / count;
+    if (shuffled) std::shuffle(kinds.begin(), kinds.end(), Random::mt);
+
+    std::vector<std::unique_ptr<EventBase>> pointers{};
+    std::vector<Variant> variants{};
+    std::vector<ErasedEvent> erased{};
+    pointers.reserve(count);
+    variants.reserve(count);
+    erased.reserve(count);
+    for (std::size_t kind : kinds) {
+      auto value{ Random::get(0u, 1000u) };
+      pointers.push_back(makeByIndex<N>(kind, [value](auto i) -> std::unique_ptr<EventBase> {
+        return std::make_unique<VirtualEvent<i>>(Event<i>{ value });
+      }));
+      variants.push_back(makeByIndex<N>(kind, [value](auto i) { return Variant{ std::in_place_index<i>, value }; }));
+      erased.push_back(makeByIndex<N>(kind, [value](auto i) {
+        return ErasedEvent{ &ErasedEvent::functionsOf<i>, value };
+      }));
+    }
+
+    std::cout << "  " << N << " types, " << (shuffled ? "shuffled" : "grouped by type") << '\n';
+    auto handle{ [](const auto& e, unsigned total) { return e.handle(total); } };
+    benchmark("virtual", pointers, [](const auto& p, unsigned total) { return p->handle(total); });
+    benchmark("std::visit", variants, [&](const Variant& v, unsigned total) {
+      return std::visit([&](const auto& e) { return handle(e, total); }, v);
+    });
+    benchmark("table of function pointers", variants, [&](const Variant& v, unsigned total) {
+      auto visitor{ [&](const auto& e) { return handle(e, total); } };
+      return tableVisit(visitor, v);
+    });
+    benchmark("Poly::fastVisit", variants, [&](const Variant& v, unsigned total) {
+      return Poly::fastVisit([&](const auto& e) { return handle(e, total); }, v);
+    });
+    benchmark("type erasure", erased, [](const ErasedEvent& e, unsigned total) {
+      return e.functions->handle(e.value, total);
+    });
+  }
+}
+
+// the overloads helper of tour_of_cpp 15.4.1
+template<class... Ts> struct overloads : Ts...
+{
+  using Ts::operator()...;
+};
+
+struct Base
+{};
+struct Derived : Base
+{};
+
+int main()
+{
+  // fastVisit() works like std::visit, on the variant of 15.4.1 too
+  using var_t = std::variant<int, std::string, Derived>;
+  const auto visitor = overloads{ [](int i) { return "int = " + std::to_string(i); },
+    [](std::string_view s) { return "string = \"" + std::string{ s } + '"'; },
+    [](const Base&) { return std::string{ "base" }; } };
+  const var_t var1 = 42, var2 = "abc", var3 = Derived();
+  for (const var_t* v : { &var1, &var2, &var3 }) assert(Poly::fastVisit(visitor, *v) == std::visit(visitor, *v));
+  var_t moved{ "moved" };
+  assert(Poly::fastVisit([](auto&& value) { return std::is_rvalue_reference_v<decltype(value)>; }, std::move(moved)));
+
+  // every alternative goes to its own case, in variants with a switch and in those left to std::visit
+  for (std::size_t kind{ 0 }; kind < 16; ++kind) {
+    auto variant{ makeByIndex<16>(kind, [](auto i) { return EventVariant<16>{ std::in_place_index<i>, 7u }; }) };
+    auto indexOf{ []<std::size_t I>(const Event<I>&) { return static_cast<unsigned>(I); } };
+    assert(Poly::fastVisit(indexOf, variant) == kind && tableVisit(indexOf, variant) == kind);
+  }
+  for (std::size_t kind{ 0 }; kind < 40; ++kind) {
+    auto variant{ makeByIndex<40>(kind, [](auto i) { return EventVariant<40>{ std::in_place_index<i>, 7u }; }) };
+    auto indexOf{ []<std::size_t I>(const Event<I>&) { return static_cast<unsigned>(I); } };
+    assert(Poly::fastVisit(indexOf, variant) == kind && tableVisit(indexOf, variant) == kind);
+  }
+
+  constexpr std::size_t count{ 10'000'000 };
+  std::cout << "dispatching " << count << " events\n";
+  benchmarkTypes<4>(count);
+  benchmarkTypes<16>(count);
+  benchmarkTypes<32>(count);
+  benchmarkTypes<48>(count);
+
+  return 0;
+}
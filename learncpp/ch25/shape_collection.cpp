@@ -0,0 +1,153 @@
+#include "../libs/poly/PolyCollection.h"
+#include "../libs/random/Random.h"
+#include "../libs/timer/Timer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+// Point, Shape, Triangle and Circle from 25.x_2, with Triangle and Circle final
+class Point
+{
+private:
+  int m_x{};
+  int m_y{};
+
+public:
+  Point(int x, int y) : m_x{ x }, m_y{ y } {}
+
+  friend std::ostream& operator<<(std::ostream& out, const Point& p)
+  {
+    return out << "Point(" << p.m_x << ", " << p.m_y << ')';
+  }
+};
+
+class Shape
+{
+public:
+  virtual std::ostream& print(std::ostream& os) const = 0;
+  friend std::ostream& operator<<(std::ostream& os, const Shape& s) { return s.print(os); }
+  virtual ~Shape() = default;
+};
+
+class Triangle final : public Shape
+{
+public:
+  Triangle(Point p1, Point p2, Point p3) : m_p1{ p1 }, m_p2{ p2 }, m_p3{ p3 } {}
+
+  std::ostream& print(std::ostream& os) const override
+  {
+    return os << "Triangle(" << m_p1 << ", " << m_p2 << ", " << m_p3 << ')';
+  }
+
+private:
+  Point m_p1;
+  Point m_p2;
+  Point m_p3;
+};
+
+class Circle final : public Shape
+{
+public:
+  Circle(Point p, int r) : m_p{ p }, m_r{ r } {}
+
+  std::ostream& print(std::ostream& os) const override { return os << "Circle(" << m_p << ", radius " << m_r << ')'; }
+
+  int getRadius() const { return m_r; }
+
+private:
+  Point m_p;
+  int m_r;
+};
+
+using Shapes = PolyCollection<Circle, Triangle>;
+
+// getLargestRadius() from 25.x_2: a pointer to follow and a dynamic_cast for every shape
+int getLargestRadius(const std::vector<std::unique_ptr<Shape>>& v)
+{
+  int mr{ -1 };
+  for (const auto& s : v) {
+    if (auto* c{ dynamic_cast<const Circle*>(s.get()) }) { mr = std::max(c->getRadius(), mr); }
+  }
+  return mr;
+}
+
+// Only the circles, one after the other
+int getLargestRadius(const Shapes& shapes)
+{
+  int mr{ -1 };
+  for (const Circle& c : shapes.all<Circle>()) mr = std::max(c.getRadius(), mr);
+  return mr;
+}
+
+// Every kind of shape must be handled, or forEach() doesn't compile
+struct ShapeCounter
+{
+  std::size_t circles{ 0 };
+  std::size_t triangles{ 0 };
+
+  void operator()(const Circle&) { ++circles; }
+  void operator()(const Triangle&) { ++triangles; }
+};
+
+template<typename LargestRadius> void benchmark(const char* name, LargestRadius largestRadius)
+{
+  Timer t{};
+  int radius{ largestRadius() };
+  std::cout << "  " << name << ": " << t.elapsed() * 1e3 << " ms (largest radius " << radius << ")\n";
+}
+
+int main()
+{
+  // the shapes of 25.x_2
+  Shapes shapes{};
+  shapes.emplace<Circle>(Point{ 1, 2 }, 7);
+  shapes.emplace<Triangle>(Point{ 1, 2 }, Point{ 3, 4 }, Point{ 5, 6 });
+  shapes.insert(Circle{ Point{ 7, 8 }, 3 });
+
+  shapes.forEach([](const Shape& s) { std::cout << s << '\n'; });
+  std::cout << "The largest radius is: " << getLargestRadius(shapes) << '\n';
+
+  assert(shapes.size() == 3 && shapes.count<Circle>() == 2 && shapes.count<Triangle>() == 1);
+  ShapeCounter counter{};
+  shapes.forEach(counter);
+  assert(counter.circles == 2 && counter.triangles == 1);
+  std::ostringstream circles{};
+  for (const Circle& c : shapes.all<Circle>()) circles << c << ' ';
+  assert(circles.str() == "Circle(Point(1, 2), radius 7) Circle(Point(7, 8), radius 3) ");
+  shapes.clear();
+  assert(shapes.empty() && getLargestRadius(shapes) == -1);
+
+  // the same shapes both ways, circles and triangles mixed at random
+  constexpr std::size_t count{ 10'000'000 };
+  std::vector<std::unique_ptr<Shape>> pointers{};
+  pointers.reserve(count);
+  shapes.reserve<Circle>(count / 2 + count / 100);
+  shapes.reserve<Triangle>(count / 2 + count / 100);
+  for (std::size_t i{ 0 }; i < count; ++i) {
+    Point p{ Random::get(-1000, 1000), Random::get(-1000, 1000) };
+    if (Random::get(0, 1)) {
+      Circle c{ p, Random::get(1, 1'000'000) };
+      pointers.push_back(std::make_unique<Circle>(c));
+      shapes.insert(c);
+    } else {
+      Triangle t{ p, Point{ 0, 0 }, Point{ 1, 1 } };
+      pointers.push_back(std::make_unique<Triangle>(t));
+      shapes.insert(t);
+    }
+  }
+  // allocations made one after the other sit next to each other, shuffling puts them where a long-running program
+  // would have them
+  std::shuffle(pointers.begin(), pointers.end(), Random::mt);
+
+  std::cout << "largest radius of " << count << " shapes\n";
+  benchmark("unique_ptr<Shape> + dynamic_cast (25.x_2)", [&] { return getLargestRadius(pointers); });
+  benchmark("PolyCollection::all<Circle>()", [&] { return getLargestRadius(shapes); });
+  assert(getLargestRadius(pointers) == getLargestRadius(shapes));
+
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include "../../libs/bits/BitVector.h"
+#include "../../libs/random/Random.h"
+#include "../../libs/timer/Timer.h"
+#include <algorithm> // for std::count
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+int main()
+{
+  BitVector bits(100);
+  bits.set(3);
+  bits.set(64);
+  bits.set(99);
+  assert(bits.count() == 3);
+  bits.buildIndex();
+  assert(bits.rank(3) == 0 && bits.rank(4) == 1 && bits.rank(100) == 3);
+  assert(bits.select(0) == 3 && bits.select(1) == 64 && bits.select(2) == 99);
+
+  BitVector ones(100, true);
+  ones.andNot(bits);
+  assert(ones.count() == 97 && !ones[64]);
+  assert((ones | bits).count() == 100 && (ones & bits).count() == 0);
+
+  // a sparse vector puts many superblocks between two select samples, and empty superblocks between set bits
+  BitVector sparse(50'000'000);
+  std::vector<std::size_t> sparsePositions{};
+  for (std::size_t i{ 5 }; i < sparse.size(); i += Random::get<std::size_t>(1, 20'000)) {
+    sparse.set(i);
+    sparsePositions.push_back(i);
+  }
+  sparse.buildIndex();
+  for (std::size_t k{ 0 }; k < sparsePositions.size(); ++k) assert(sparse.select(k) == sparsePositions[k]);
+
+  // a few hundred million flags, about one in three is set
+  constexpr std::size_t size{ 200'000'000 };
+  BitVector flags(size);
+  std::vector<bool> vectorFlags(size);
+  for (std::size_t i{ 0 }; i < size; i += Random::get<std::size_t>(1, 5)) {
+    flags.set(i);
+    vectorFlags[i] = true;
+  }
+
+  Timer t{};
+  auto vectorCount{ static_cast<std::size_t>(std::count(vectorFlags.begin(), vectorFlags.end(), true)) };
+  std::cout << "std::vector<bool> count: " << t.elapsed() << " s\n";
+
+  t.reset();
+  std::size_t vectorLoop{ 0 };
+  for (std::size_t i{ 0 }; i < size; ++i) vectorLoop += vectorFlags[i];
+  std::cout << "std::vector<bool> per-bit loop: " << t.elapsed() << " s\n";
+
+  t.reset();
+  std::size_t count{ flags.count() };
+  std::cout << "BitVector count: " << t.elapsed() << " s\n";
+  assert(count == vectorCount && count == vectorLoop);
+
+  BitVector other(size);
+  for (std::size_t i{ 0 }; i < size; i += 7) other.set(i);
+  t.reset();
+  BitVector both{ flags & other };
+  flags ^= other;
+  flags.andNot(both);
+  std::cout << "BitVector and/xor/andNot: " << t.elapsed() << " s\n";
+
+  t.reset();
+  flags.buildIndex();
+  std::cout << "BitVector buildIndex: " << t.elapsed() << " s\n";
+
+  constexpr std::size_t queries{ 10'000'000 };
+  std::vector<std::size_t> positions(queries);
+  for (auto& p : positions) p = Random::get<std::size_t>(0, size);
+  std::size_t setBits{ flags.count() };
+
+  t.reset();
+  std::size_t checksum{ 0 };
+  for (std::size_t p : positions) checksum += flags.rank(p);
+  std::cout << "BitVector " << queries << " rank: " << t.elapsed() << " s\n";
+
+  t.reset();
+  for (std::size_t p : positions) checksum += flags.select(p % setBits);
+  std::cout << "BitVector " << queries << " select: " << t.elapsed() << " s\n";
+
+  // rank and select are inverses of each other
+  for (std::size_t i{ 0 }; i < 1000; ++i) {
+    std::size_t k{ positions[i] % setBits };
+    assert(flags.rank(flags.select(k)) == k);
+  }
+  std::cout << "(checksum " << checksum << ")\n";
+
+  return 0;
+}
@@ -0,0 +1,37 @@
+/*
+C++20 module alternative to Array.h / ArrayExtern.h. The module interface is compiled once into a binary module
+interface, and `import array;` loads it instead of parsing the header again in every translation unit.
+
+Build with GCC (the interface must be compiled before its importers):
+  g++ -std=c++23 -fmodules-ts -x c++ -c Array.cppm -o Array.o
+  g++ -std=c++23 -fmodules-ts -c main_module.cpp
+  g++ Array.o main_module.o
+
+Array here is attached to the module, so it's a different entity from the one in Array.h. Don't mix `import array;`
+and `#include "Array.h"` in the same program.
+*/
+module;
+
+// The global module fragment. Everything Array.h includes is included here first, so the includes inside the export
+// block below are skipped by their include guards and the standard library doesn't end up in the module's purview.
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+export module array;
+
+export {
+#include "Array.h"
+}
+
+// Like the explicit instantiations in templates.cpp, these are compiled into the module's object file once
+template class Array<int>;
+template class Array<double>;
+template class Array<float>;
+template class Array<std::int64_t>;
@@ -2,46 +2,207 @@
 #define ARRAY_H
 
 #include <cassert>
+#include <cstddef>
+#include <cstring> // for std::memcpy
+#include <memory> // for std::allocator_traits
+#include <new> // for std::align_val_t
+#include <span>
+#include <type_traits>
+#include <utility>
 
-template<typename T> // added
-class Array
+// Allocator that returns memory aligned to Alignment bytes (a cache line by default), so that SIMD kernels can use
+// aligned loads on data() and two arrays never share a cache line.
+template<typename T, std::size_t Alignment = 64> struct AlignedAllocator
+{
+  static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+  using value_type = T;
+
+  // allocator_traits can't deduce rebind for allocators with non-type template parameters
+  template<typename U> struct rebind
+  {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+  template<typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+  T* allocate(std::size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ Alignment })); }
+  void deallocate(T* p, std::size_t) noexcept { ::operator delete(p, std::align_val_t{ Alignment }); }
+
+  template<typename U> friend bool operator==(const AlignedAllocator&, const AlignedAllocator<U, Alignment>&)
+  {
+    return true;
+  }
+};
+
+/*
+Array<T> is allocator-aware: memory comes from Allocator (64-byte aligned by default) and elements are constructed and
+destroyed through std::allocator_traits.
+
+Elements of trivially default constructible types (int, double, ...) are left uninitialized, like `new T[length]`
+without braces, because numeric buffers are usually written before they're read. Other types are value-initialized.
+
+resize() relocates the elements when it needs a larger buffer. Trivially copyable types are relocated with one memcpy.
+Other types are moved with std::move_if_noexcept, so a throwing move constructor falls back to copying and a failed
+resize leaves the array unchanged.
+*/
+template<typename T, typename Allocator = AlignedAllocator<T>> class Array
 {
 private:
+  using Traits = std::allocator_traits<Allocator>;
+
   int m_length{};
-  T* m_data{}; // changed type to T
+  int m_capacity{};
+  T* m_data{};
+  [[no_unique_address]] Allocator m_allocator{};
+
+  // Constructs elements [first, last) in place
+  void construct(T* data, int first, int last);
+  void destroy(T* data, int first, int last) noexcept;
+  // Moves m_length elements into a new buffer with the given capacity
+  void relocate(int capacity);
 
 public:
-  Array(int length)
-  {
-    assert(length > 0);
-    m_data = new T[length]{}; // allocated an array of objects of type T
-    m_length = length;
-  }
+  Array() = default;
+
+  explicit Array(int length, const Allocator& allocator = Allocator{});
 
   Array(const Array&) = delete;
   Array& operator=(const Array&) = delete;
 
-  ~Array() { delete[] m_data; }
+  Array(Array&& arr) noexcept
+    : m_length{ std::exchange(arr.m_length, 0) }, m_capacity{ std::exchange(arr.m_capacity, 0) },
+      m_data{ std::exchange(arr.m_data, nullptr) }, m_allocator{ std::move(arr.m_allocator) }
+  {}
+
+  Array& operator=(Array&& arr) noexcept;
 
-  void erase()
+  ~Array() { erase(); }
+
+  void erase();
+  void reserve(int capacity);
+  // Growing beyond the capacity at least doubles it, so repeated resizes are amortized O(1) per element
+  void resize(int length);
+
+  // The accessors stay inside the class: they're inline, so element access in a loop compiles to a load even in files
+  // that include ArrayExtern.h
+  T& operator[](int index) // now returns a T&
   {
-    delete[] m_data;
-    // We need to make sure we set m_data to 0 here, otherwise it will be left pointing at deallocated memory!
-    m_data = nullptr;
-    m_length = 0;
+    assert(index >= 0 && index < m_length);
+    return m_data[index];
   }
 
-  // templated operator[] function defined below
-  T& operator[](int index); // now returns a T&
-
   int getLength() const { return m_length; }
+  int getCapacity() const { return m_capacity; }
+
+  // Contiguous storage for SIMD kernels, aligned to the allocator's alignment
+  T* data() { return m_data; }
+  const T* data() const { return m_data; }
+  std::span<T> span() { return { m_data, static_cast<std::size_t>(m_length) }; }
+  std::span<const T> span() const { return { m_data, static_cast<std::size_t>(m_length) }; }
 };
 
-// member functions defined outside the class need their own template declaration
-template<typename T> T& Array<T>::operator[](int index) // now returns a T&
+/*
+Member functions defined outside the class need their own template declaration. Unlike members defined inside the
+class, they aren't implicitly inline, so `extern template class Array<int>;` (ArrayExtern.h) really keeps them from
+being instantiated: the compiler may instantiate an inline function anyway to inline it, but never one of these. Only
+the members that allocate, construct or destroy are defined here, a call to them costs little next to their work.
+*/
+template<typename T, typename Allocator> void Array<T, Allocator>::construct(T* data, int first, int last)
 {
-  assert(index >= 0 && index < m_length);
-  return m_data[index];
+  if constexpr (!std::is_trivially_default_constructible_v<T>) {
+    int i{ first };
+    try {
+      for (; i < last; ++i) Traits::construct(m_allocator, data + i);
+    } catch (...) {
+      destroy(data, first, i);
+      throw;
+    }
+  }
+}
+
+template<typename T, typename Allocator> void Array<T, Allocator>::destroy(T* data, int first, int last) noexcept
+{
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    for (int i{ first }; i < last; ++i) Traits::destroy(m_allocator, data + i);
+  }
+}
+
+template<typename T, typename Allocator> void Array<T, Allocator>::relocate(int capacity)
+{
+  T* data{ Traits::allocate(m_allocator, static_cast<std::size_t>(capacity)) };
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    if (m_length > 0) std::memcpy(data, m_data, static_cast<std::size_t>(m_length) * sizeof(T));
+  } else {
+    int i{ 0 };
+    try {
+      for (; i < m_length; ++i) Traits::construct(m_allocator, data + i, std::move_if_noexcept(m_data[i]));
+    } catch (...) {
+      destroy(data, 0, i);
+      Traits::deallocate(m_allocator, data, static_cast<std::size_t>(capacity));
+      throw;
+    }
+    destroy(m_data, 0, m_length);
+  }
+  if (m_data) Traits::deallocate(m_allocator, m_data, static_cast<std::size_t>(m_capacity));
+  m_data = data;
+  m_capacity = capacity;
+}
+
+template<typename T, typename Allocator>
+Array<T, Allocator>::Array(int length, const Allocator& allocator) : m_allocator{ allocator }
+{
+  assert(length > 0);
+  m_data = Traits::allocate(m_allocator, static_cast<std::size_t>(length));
+  m_capacity = length;
+  try {
+    construct(m_data, 0, length);
+  } catch (...) {
+    Traits::deallocate(m_allocator, m_data, static_cast<std::size_t>(length));
+    throw;
+  }
+  m_length = length;
+}
+
+template<typename T, typename Allocator> Array<T, Allocator>& Array<T, Allocator>::operator=(Array&& arr) noexcept
+{
+  static_assert(Traits::is_always_equal::value || Traits::propagate_on_container_move_assignment::value,
+    "Array only supports allocators that can be moved with the memory they own");
+  if (&arr == this) return *this;
+  erase();
+  if constexpr (Traits::propagate_on_container_move_assignment::value) m_allocator = std::move(arr.m_allocator);
+  m_length = std::exchange(arr.m_length, 0);
+  m_capacity = std::exchange(arr.m_capacity, 0);
+  m_data = std::exchange(arr.m_data, nullptr);
+  return *this;
+}
+
+template<typename T, typename Allocator> void Array<T, Allocator>::erase()
+{
+  destroy(m_data, 0, m_length);
+  if (m_data) Traits::deallocate(m_allocator, m_data, static_cast<std::size_t>(m_capacity));
+  // We need to make sure we set m_data to 0 here, otherwise it will be left pointing at deallocated memory!
+  m_data = nullptr;
+  m_length = 0;
+  m_capacity = 0;
+}
+
+template<typename T, typename Allocator> void Array<T, Allocator>::reserve(int capacity)
+{
+  if (capacity > m_capacity) relocate(capacity);
+}
+
+template<typename T, typename Allocator> void Array<T, Allocator>::resize(int length)
+{
+  assert(length >= 0);
+  if (length > m_capacity) relocate(length > 2 * m_capacity ? length : 2 * m_capacity);
+  if (length > m_length) {
+    construct(m_data, m_length, length);
+  } else {
+    destroy(m_data, length, m_length);
+  }
+  m_length = length;
 }
 
 #endif
@@ -0,0 +1,22 @@
+#ifndef ARRAY_EXTERN_H
+#define ARRAY_EXTERN_H
+
+#include "Array.h"
+#include <cstdint>
+
+/*
+Include this header instead of Array.h when linking with templates.cpp. The extern template declarations tell the
+compiler that Array<T> for these element types is explicitly instantiated in another translation unit, so the member
+functions aren't instantiated (and compiled and optimized) again in every file that uses them. The linker uses the
+single copy from templates.cpp. This only works for the members Array.h defines outside the class (the constructor,
+resize() and the others that allocate or destroy). The accessors like operator[] and data() are defined inside, so
+they're inline and still compiled into every file, where element access stays a plain load.
+
+Other element types still work, they're instantiated implicitly as usual.
+*/
+extern template class Array<int>;
+extern template class Array<double>;
+extern template class Array<float>;
+extern template class Array<std::int64_t>;
+
+#endif
@@ -0,0 +1,67 @@
+#!/usr/bin/env bash
+# Compares build times of many translation units that use Array<T>:
+#   header-only:     every file includes Array.h and instantiates Array<int>/Array<double> itself
+#   extern template: every file includes ArrayExtern.h and links against templates.cpp, which is compiled once
+#   module:          every file does `import array;`, Array.cppm is compiled once (GCC, -fmodules-ts)
+#
+# Usage: ./compile_benchmark.sh [number of translation units] [compiler flags]
+set -euo pipefail
+
+units=${1:-100}
+flags=${2:--std=c++23 -O2}
+cxx=${CXX:-g++}
+src=$(cd "$(dirname "$0")" && pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+for ((i = 0; i < units; ++i)); do
+  for mode in header extern module; do
+    include="#include \"$src/Array.h\""
+    [[ $mode == extern ]] && include="#include \"$src/ArrayExtern.h\""
+    [[ $mode == module ]] && include="import array;"
+    mkdir -p "$work/$mode"
+    cat >"$work/$mode/unit$i.cpp" <<CPP
+$include
+
+double unit$i(int length)
+{
+  Array<int> ints{ length };
+  Array<double> doubles{ length };
+  for (int i{ 0 }; i < length; ++i) {
+    ints[i] = i;
+    doubles[i] = i * 0.5;
+  }
+  ints.resize(length * 2);
+  doubles.reserve(length * 4);
+  double sum{ 0 };
+  const double* data{ doubles.data() };
+  for (int i{ 0 }; i < length; ++i) sum += data[i];
+  return sum + ints.getLength();
+}
+CPP
+  done
+done
+
+build()
+{
+  local mode=$1
+  local start end
+  start=$(date +%s.%N)
+  if [[ $mode == module ]]; then
+    # the module interface has to exist before its importers are compiled, gcm.cache is created in the current directory
+    (cd "$work/$mode" && $cxx $flags -fmodules-ts -x c++ -c "$src/Array.cppm" -o array.o \
+      && for f in unit*.cpp; do $cxx $flags -fmodules-ts -c "$f" -o "${f%.cpp}.o"; done)
+  else
+    for f in "$work/$mode"/*.cpp; do $cxx $flags -c "$f" -o "${f%.cpp}.o"; done
+    if [[ $mode == extern ]]; then $cxx $flags -c "$src/templates.cpp" -o "$work/$mode/templates.o"; fi
+  fi
+  end=$(date +%s.%N)
+  local size
+  size=$(cat "$work/$mode"/*.o | wc -c)
+  printf '%-16s %6.2f s, %8d bytes of object code\n' "$mode" "$(awk "BEGIN { print $end - $start }")" "$size"
+}
+
+echo "$units translation units, $cxx $flags"
+build header
+build extern
+build module
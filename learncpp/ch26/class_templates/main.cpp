@@ -1,5 +1,9 @@
-#include "Array.h"
+#include "ArrayExtern.h"
+#include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <numeric> // for std::reduce
+#include <string>
 
 /*
 Just like with function templates, the compiler will only instantiate a class template if the class template is used in
@@ -27,6 +31,11 @@ template class Array<double>; // Explicitly instantiate template Array<double>
 // instantiate other templates here
 -----------------------------------------
 Compiler will instantiate templates only once and linker will use them in all other files.
+
+This directory uses the third approach for the common element types: templates.cpp explicitly instantiates them, and
+ArrayExtern.h declares `extern template class Array<int>;` etc., so files that include it don't instantiate those
+members again. This file includes ArrayExtern.h, so it's built with `g++ main.cpp templates.cpp`. Array.cppm is the
+C++20 module alternative (see main_module.cpp), and compile_benchmark.sh compares the build times of all three.
 */
 
 int main()
@@ -42,5 +51,21 @@ int main()
 
   for (int count{ length - 1 }; count >= 0; --count) std::cout << intArray[count] << '\t' << doubleArray[count] << '\n';
 
+  // data() is aligned to 64 bytes, so SIMD kernels can use aligned loads
+  assert(reinterpret_cast<std::uintptr_t>(doubleArray.data()) % 64 == 0);
+  auto s{ doubleArray.span() };
+  std::cout << "sum: " << std::reduce(s.begin(), s.end()) << '\n';
+
+  // ints are relocated with memcpy, std::string (not trivially copyable) is moved element by element
+  intArray.resize(100);
+  assert(intArray[11] == 11);
+  Array<std::string> strings{ 2 };
+  strings[0] = "hello";
+  strings.resize(3);
+  assert(strings[0] == "hello" && strings[2].empty());
+
+  Array<int> moved{ std::move(intArray) };
+  assert(moved.getLength() == 100 && intArray.getLength() == 0);
+
   return 0;
 }
\ No newline at end of file
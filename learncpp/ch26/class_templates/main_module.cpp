@@ -0,0 +1,14 @@
+#include <iostream>
+
+import array;
+
+int main()
+{
+  Array<int> intArray{ 12 };
+  for (int count{ 0 }; count < intArray.getLength(); ++count) intArray[count] = count;
+  intArray.resize(24);
+
+  std::cout << intArray.getLength() << ' ' << intArray[11] << '\n';
+
+  return 0;
+}
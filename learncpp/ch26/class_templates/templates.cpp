@@ -0,0 +1,10 @@
+// Ensure the full Array template definition can be seen
+#include "Array.h"
+#include <cstdint>
+
+// Explicitly instantiate the common element types once. Every member function is compiled here, and files that include
+// ArrayExtern.h link against these instead of instantiating their own copies.
+template class Array<int>;
+template class Array<double>;
+template class Array<float>;
+template class Array<std::int64_t>;
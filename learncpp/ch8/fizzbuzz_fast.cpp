@@ -0,0 +1,185 @@
+#include "../libs/io/FizzBuzz.h"
+#include "../libs/io/OutputBuffer.h"
+#include "../libs/timer/Timer.h"
+#include <cassert>
+#include <cstdint>
+#include <cstdio> // std::tmpfile, std::fread
+#include <cstdlib> // std::strtoull
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility> // for std::pair
+#include <vector>
+#include <fcntl.h> // open
+#include <unistd.h> // pipe, read, close
+
+// Usage: fizzbuzz_fast <n> prints fizzbuzz (3, 5, 7) from 1 to n, fastest into a pipe (e.g. | pv > /dev/null).
+// Without arguments it checks the output against 8.10_3 and 16.6_6 and measures the throughput into /dev/null.
+
+// fizzbuzz() from 8.10_3, printing to any stream
+void fizzbuzz(std::ostream& out, int num)
+{
+  for (int i{ 1 }; i <= num; ++i) {
+    int rem3{ i % 3 };
+    int rem5{ i % 5 };
+    int rem7{ i % 7 };
+    if (rem3 && rem5 && rem7) { out << i; }
+    if (!rem3) { out << "fizz"; }
+    if (!rem5) { out << "buzz"; }
+    if (!rem7) { out << "pop"; }
+    out << '\n';
+  }
+}
+
+// fizzbuzz() from 16.6_6, printing to any stream
+void fizzbuzz(std::ostream& out, int n, const std::vector<int>& divisors, const std::vector<std::string_view>& words)
+{
+  for (int i{ 1 }; i <= n; ++i) {
+    bool printed{ false };
+    for (std::size_t j{ 0 }; j < divisors.size(); ++j) {
+      if (i % divisors[j] == 0) {
+        out << words[j];
+        printed = true;
+      }
+    }
+    if (!printed) { out << i; }
+    out << '\n';
+  }
+}
+
+// Everything the generator writes for lines 1 to n, through a temporary file
+std::string generate(const FizzBuzz& fizzBuzz, std::uint64_t n)
+{
+  std::FILE* file{ std::tmpfile() };
+  assert(file);
+  {
+    OutputBuffer out{ fileno(file), 4096 }; // a small buffer, to flush in the middle of periods
+    fizzBuzz.write(out, n);
+    out.flush();
+  }
+  std::string text(static_cast<std::size_t>(std::ftell(file)), '\0');
+  std::rewind(file);
+  std::size_t read{ std::fread(text.data(), 1, text.size(), file) };
+  assert(read == text.size());
+  std::fclose(file);
+  return text;
+}
+
+// The same through a pipe, which the buffer splices its pages into. Returns the text and the number of splices.
+std::pair<std::string, std::uint64_t> generateThroughPipe(const FizzBuzz& fizzBuzz, std::uint64_t n)
+{
+  int ends[2]{};
+  [[maybe_unused]] int result{ ::pipe(ends) };
+  assert(result == 0);
+  std::string text{};
+  std::thread reader{ [&text, fd = ends[0]] {
+    char chunk[65536];
+    for (ssize_t count{}; (count = ::read(fd, chunk, sizeof(chunk))) > 0;) {
+      text.append(chunk, static_cast<std::size_t>(count));
+    }
+  } };
+  std::uint64_t splices{ 0 };
+  {
+    OutputBuffer out{ ends[1] };
+    fizzBuzz.write(out, n);
+    out.flush();
+    splices = out.splices();
+  }
+  ::close(ends[1]);
+  reader.join();
+  ::close(ends[0]);
+  return { text, splices };
+}
+
+// Lines 1 to n into /dev/null, returns the number of bytes
+std::uint64_t writeToNull(const FizzBuzz& fizzBuzz, std::uint64_t n)
+{
+  int fd{ ::open("/dev/null", O_WRONLY) };
+  assert(fd >= 0);
+  std::uint64_t bytes{};
+  {
+    OutputBuffer out{ fd };
+    fizzBuzz.write(out, n);
+    out.flush();
+    bytes = out.written();
+  }
+  ::close(fd);
+  return bytes;
+}
+
+// print() returns the number of bytes it printed
+template<typename Print> void benchmark(const char* name, Print print)
+{
+  Timer t{};
+  std::uint64_t bytes{ print() };
+  double seconds{ t.elapsed() };
+  std::cout << "  " << name << ": " << static_cast<double>(bytes) / seconds / 1e9 << " GB/s\n";
+}
+
+int main(int argc, char* argv[])
+{
+  const std::vector divisors3{ 3, 5, 7 };
+  const std::vector<std::string_view> words3{ "fizz", "buzz", "pop" };
+  const std::vector divisors7{ 3, 5, 7, 11, 13, 17, 19 };
+  const std::vector<std::string_view> words7{ "fizz", "buzz", "pop", "bang", "jazz", "pow", "boom" };
+  FizzBuzz fizzBuzz3{ divisors3, words3 };
+
+  if (argc > 1) {
+    OutputBuffer out{ STDOUT_FILENO };
+    fizzBuzz3.write(out, std::strtoull(argv[1], nullptr, 10));
+    out.flush();
+    return 0;
+  }
+
+  for (std::uint64_t number : { 0ull, 9ull, 10ull, 99ull, 100ull, 12345ull, 9'999'999'999ull, 10'000'000'000ull }) {
+    char text[OutputBuffer::maxNumberLength]{};
+    assert(std::string(text, OutputBuffer::formatNumber(text, number)) == std::to_string(number));
+  }
+  constexpr std::uint64_t max{ std::numeric_limits<std::uint64_t>::max() };
+  char maxText[OutputBuffer::maxNumberLength]{};
+  assert(std::string(maxText, OutputBuffer::formatNumber(maxText, max)) == std::to_string(max));
+
+  FizzBuzz fizzBuzz7{ divisors7, words7 };
+  assert(fizzBuzz3.period() == 105 && fizzBuzz7.period() == 4'849'845);
+  for (int n : { 0, 1, 104, 105, 106, 1000, 250'000 }) {
+    std::ostringstream expected3{};
+    fizzbuzz(expected3, n);
+    assert(generate(fizzBuzz3, static_cast<std::uint64_t>(n)) == expected3.str());
+    std::ostringstream expected7{};
+    fizzbuzz(expected7, n, divisors7, words7);
+    assert(generate(fizzBuzz7, static_cast<std::uint64_t>(n)) == expected7.str());
+  }
+  std::ostringstream expected{};
+  fizzbuzz(expected, 5'000'000);
+  // tens of megabytes, so every full buffer goes into the pipe with vmsplice() and only the last one is copied
+  auto [piped3, splices3]{ generateThroughPipe(fizzBuzz3, 5'000'000) };
+  assert(piped3 == expected.str() && splices3 == piped3.size() / OutputBuffer::defaultCapacity);
+  auto [piped7, splices7]{ generateThroughPipe(fizzBuzz7, 5'000'000) };
+  assert(piped7 == generate(fizzBuzz7, 5'000'000) && splices7 == piped7.size() / OutputBuffer::defaultCapacity);
+
+  constexpr int streamLines{ 20'000'000 };
+  constexpr std::uint64_t bufferLines{ 500'000'000 };
+  std::cout << "fizzbuzz into /dev/null\n";
+  std::uint64_t streamBytes3{ writeToNull(fizzBuzz3, streamLines) };
+  benchmark("8.10_3 into a std::ofstream", [&] {
+    std::ofstream out{ "/dev/null" };
+    fizzbuzz(out, streamLines);
+    return streamBytes3;
+  });
+  benchmark("FizzBuzz into an OutputBuffer", [&] { return writeToNull(fizzBuzz3, bufferLines); });
+
+  std::cout << "fizzbuzz with 7 divisors into /dev/null\n";
+  std::uint64_t streamBytes7{ writeToNull(fizzBuzz7, streamLines) };
+  benchmark("16.6_6 into a std::ofstream", [&] {
+    std::ofstream out{ "/dev/null" };
+    fizzbuzz(out, streamLines, divisors7, words7);
+    return streamBytes7;
+  });
+  benchmark("FizzBuzz into an OutputBuffer", [&] { return writeToNull(fizzBuzz7, bufferLines); });
+
+  return 0;
+}
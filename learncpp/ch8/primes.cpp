@@ -0,0 +1,115 @@
+#include "../libs/primes/Primes.h"
+#include "../libs/random/Random.h"
+#include "../libs/threads/ThreadPool.h"
+#include "../libs/timer/Timer.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+// isPrime() from 8.x_2: trial division by every odd number up to the square root
+bool isPrime(int x)
+{
+  if (x <= 1) return false;
+  if (x != 2 && (x % 2 == 0)) { return false; }
+
+  for (int i{ 3 }; i <= x / i; i += 2) {
+    if (x % i == 0) { return false; }
+  }
+  return true;
+}
+
+template<typename Classify>
+void benchmark(const char* name, const std::vector<std::uint64_t>& values, std::span<bool> results, Classify classify)
+{
+  Timer t{};
+  classify(std::span<const std::uint64_t>{ values }, results);
+  std::size_t primes{ 0 };
+  for (bool r : results) primes += r;
+  std::cout << "  " << name << ": " << t.elapsed() / static_cast<double>(values.size()) * 1e9 << " ns per number ("
+            << primes << " primes)\n";
+}
+
+std::vector<std::uint64_t> randomValues(std::size_t count, std::uint64_t max)
+{
+  std::vector<std::uint64_t> values(count);
+  for (auto& v : values) v = Random::get<std::uint64_t>(0, max);
+  return values;
+}
+
+int main()
+{
+  // the tests of 8.x_2
+  assert(!Primes::isPrime(0) && !Primes::isPrime(1) && Primes::isPrime(2) && Primes::isPrime(3));
+  assert(!Primes::isPrime(4) && Primes::isPrime(5) && Primes::isPrime(7) && !Primes::isPrime(9));
+  assert(Primes::isPrime(11) && Primes::isPrime(13) && !Primes::isPrime(15) && !Primes::isPrime(16));
+  assert(Primes::isPrime(17) && Primes::isPrime(19) && Primes::isPrime(97) && !Primes::isPrime(99));
+  assert(Primes::isPrime(13417));
+
+  // every number below 2^20, by trial division and by the sieve
+  constexpr std::uint64_t checkLimit{ 1 << 20 };
+  std::vector<std::uint64_t> sieved{ Primes::primesBetween(0, checkLimit) };
+  std::size_t next{ 0 };
+  for (std::uint64_t n{ 0 }; n < checkLimit; ++n) {
+    bool prime{ next < sieved.size() && sieved[next] == n };
+    next += prime;
+    assert(Primes::isPrime(n) == prime && isPrime(static_cast<int>(n)) == prime);
+  }
+  assert(next == sieved.size());
+
+  // Carmichael numbers, strong pseudoprimes to many bases, and primes near the top of the range
+  assert(!Primes::isPrime(561) && !Primes::isPrime(3'215'031'751) && !Primes::isPrime(3'825'123'056'546'413'051));
+  assert(!Primes::isPrime(4'759'123'141ull * 3) && !Primes::isPrime(4'294'967'291ull * 4'294'967'279ull));
+  assert(Primes::isPrime(4'294'967'291) && Primes::isPrime(2'305'843'009'213'693'951)); // 2^32 - 5, 2^61 - 1
+  assert(Primes::isPrime(18'446'744'073'709'551'557u) && !Primes::isPrime(18'446'744'073'709'551'615u));
+
+  // sieved windows far from 0, in parallel too, against Miller-Rabin
+  ThreadPool& pool{ ThreadPool::global() };
+  for (std::uint64_t low : { 0ull, 1ull, 3ull, 1'000'000'007ull, 1'000'000'000'000ull, 1'000'000'000'000'000ull }) {
+    std::uint64_t high{ low + 300'001 };
+    std::vector<std::uint64_t> window{ Primes::primesBetween(low, high, pool) };
+    assert(window == Primes::primesBetween(low, high));
+    assert(Primes::countPrimes(low, high) == window.size() && Primes::countPrimes(low, high, pool) == window.size());
+    std::size_t expected{ 0 };
+    for (std::uint64_t n{ low }; n < high; ++n) expected += Primes::isPrime(n);
+    assert(window.size() == expected);
+  }
+  assert(Primes::countPrimes(0, 10'000'000) == 664'579);
+
+  constexpr std::size_t count{ 2'000'000 };
+  auto results{ std::make_unique_for_overwrite<bool[]>(count) };
+  std::span<bool> resultSpan{ results.get(), count };
+  auto trialDivision{ [](std::span<const std::uint64_t> values, std::span<bool> out) {
+    for (std::size_t i{ 0 }; i < values.size(); ++i) out[i] = isPrime(static_cast<int>(values[i]));
+  } };
+  auto millerRabin{ [](std::span<const std::uint64_t> values, std::span<bool> out) { Primes::isPrime(values, out); } };
+  auto millerRabinPool{ [&pool](std::span<const std::uint64_t> values, std::span<bool> out) {
+    Primes::isPrime(values, out, pool);
+  } };
+
+  std::cout << count << " random numbers below 2^31\n";
+  std::vector<std::uint64_t> small{ randomValues(count, std::numeric_limits<int>::max()) };
+  benchmark("trial division (8.x_2)", small, resultSpan, trialDivision);
+  benchmark("Primes::isPrime", small, resultSpan, millerRabin);
+  benchmark("Primes::isPrime, pool", small, resultSpan, millerRabinPool);
+
+  std::cout << count << " random 64-bit numbers\n";
+  std::vector<std::uint64_t> large{ randomValues(count, std::numeric_limits<std::uint64_t>::max()) };
+  benchmark("Primes::isPrime", large, resultSpan, millerRabin);
+  benchmark("Primes::isPrime, pool", large, resultSpan, millerRabinPool);
+
+  constexpr std::uint64_t sieveLimit{ 1'000'000'000 };
+  std::cout << "every number below " << sieveLimit << '\n';
+  for (bool parallel : { false, true }) {
+    Timer t{};
+    std::uint64_t primes{ parallel ? Primes::countPrimes(0, sieveLimit, pool) : Primes::countPrimes(0, sieveLimit) };
+    std::cout << "  segmented sieve" << (parallel ? ", pool" : "") << ": "
+              << t.elapsed() / static_cast<double>(sieveLimit) * 1e9 << " ns per number (" << primes << " primes)\n";
+  }
+
+  return 0;
+}
@@ -9,7 +9,7 @@ bool isPrime(int x)
   if (x <= 1) return false;
   if (x != 2 && (x % 2 == 0)) { return false; }
 
-  for (int i{ 3 }; i * i < x; i += 2) {
+  for (int i{ 3 }; i <= x / i; i += 2) {
     if (x % i == 0) { return false; }
   }
   return true;
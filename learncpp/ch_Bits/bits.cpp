@@ -0,0 +1,83 @@
+#include "../libs/bits/Bits.h"
+#include "../libs/random/Random.h"
+#include "../libs/timer/Timer.h"
+#include <bit> // for std::bit_width
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+// The recursive printBits from 20.3_1, writing into a stream
+void printBits(std::ostream& out, unsigned int num)
+{
+  if (num <= 0) return;
+  printBits(out, num / 2);
+  out << num % 2;
+}
+
+int main()
+{
+  // rotl(std::bitset<4>) from O.2_2-3
+  static_assert(Bits::rotl<4>(0b0001u, 1) == 0b0010u);
+  static_assert(Bits::rotl<4>(0b1001u, 1) == 0b0011u);
+  static_assert(Bits::rotr<4>(0b0011u, 1) == 0b1001u);
+  static_assert(Bits::rotl(std::uint8_t{ 0x81 }, 1) == 0x03);
+
+  static_assert(Bits::popcount(0xF0F0u) == 8);
+  static_assert(Bits::ctz(0b1000u) == 3 && Bits::clz(std::uint8_t{ 1 }) == 7);
+  static_assert(Bits::reverse(std::uint8_t{ 0b0000'0110 }) == 0b0110'0000);
+  static_assert(Bits::reverse(std::uint64_t{ 1 }) == std::uint64_t{ 1 } << 63);
+
+  // deposit 0b101 into the set bits of 0b1101'0000 and extract it back
+  static_assert(Bits::pdep(0b101, 0b1101'0000) == 0b1001'0000);
+  static_assert(Bits::pext(0b1001'0000, 0b1101'0000) == 0b101);
+
+  char buf[80]{};
+  auto [end, ec]{ Bits::formatBinary(std::begin(buf), std::end(buf), std::uint8_t{ 148 }) };
+  assert(ec == std::errc{} && std::string_view(buf, end) == "10010100"); // printBit(num, 128) ... printBit(num, 1)
+  end = Bits::formatBinary(std::begin(buf), std::end(buf), 5u, std::bit_width(5u)).ptr;
+  assert(std::string_view(buf, end) == "101");
+  std::cout << std::string_view(buf, Bits::formatBinary(std::begin(buf), std::end(buf), 148u, 12).ptr) << '\n';
+
+  constexpr std::size_t count{ 1'000'000 };
+  std::vector<std::uint64_t> values(count);
+  for (auto& v : values) v = Random::get<std::uint64_t>(0, std::numeric_limits<std::uint64_t>::max());
+
+  Timer t{};
+  std::ostringstream stream{};
+  for (std::size_t i{ 0 }; i < count; ++i) printBits(stream, static_cast<unsigned int>(values[i]));
+  std::cout << "recursive printBits (32 bits): " << t.elapsed() << " s\n";
+
+  t.reset();
+  std::vector<char> output(count * 64);
+  char* out{ output.data() };
+  for (std::size_t i{ 0 }; i < count; ++i) {
+    out = Bits::formatBinary(out, output.data() + output.size(), static_cast<unsigned int>(values[i])).ptr;
+  }
+  std::cout << "formatBinary (32 bits): " << t.elapsed() << " s\n";
+
+  std::uint64_t checksum{ 0 };
+  t.reset();
+  for (std::size_t i{ 0 }; i + 1 < count; ++i) checksum += Bits::pdepPortable(values[i], values[i + 1]);
+  std::cout << "portable pdep: " << t.elapsed() << " s\n";
+
+  t.reset();
+  for (std::size_t i{ 0 }; i + 1 < count; ++i) checksum -= Bits::pdep(values[i], values[i + 1]);
+#if defined(__BMI2__)
+  std::cout << "BMI2 pdep: " << t.elapsed() << " s\n";
+#else
+  std::cout << "pdep (no BMI2, compile with -march=native to use the instruction): " << t.elapsed() << " s\n";
+#endif
+  assert(checksum == 0);
+
+  t.reset();
+  for (std::uint64_t v : values) checksum += Bits::reverse(v);
+  std::cout << "reverse: " << t.elapsed() << " s (checksum " << checksum << ")\n";
+
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include "../../libs/bits/RoaringBitmap.h"
+#include "../../libs/random/Random.h"
+#include "../../libs/timer/Timer.h"
+#include <algorithm> // for std::set_intersection, ...
+#include <array>
+#include <bit> // for std::countr_zero
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator> // for std::inserter
+#include <set>
+#include <vector>
+
+constexpr std::uint8_t option_viewed{ 0x01 };
+constexpr std::uint8_t option_edited{ 0x02 };
+constexpr std::uint8_t option_favorited{ 0x04 };
+constexpr std::uint8_t option_shared{ 0x08 };
+constexpr std::uint8_t option_deleted{ 0x10 };
+
+// One compressed bitmap of article ids per flag, so queries touch only the articles that have the flags involved
+class ArticleFlagIndex
+{
+public:
+  // Articles should be added in increasing id order, which makes every insert an append
+  void add(std::uint32_t article, std::uint8_t flags)
+  {
+    for (int bit{ 0 }; bit < 8; ++bit) {
+      if (flags & (1u << bit)) m_flags[static_cast<std::size_t>(bit)].add(article);
+    }
+  }
+
+  void runOptimize()
+  {
+    for (auto& bitmap : m_flags) bitmap.runOptimize();
+  }
+
+  // option must be one of the option_* masks
+  const RoaringBitmap& withFlag(std::uint8_t option) const
+  {
+    assert(std::has_single_bit(option));
+    return m_flags[static_cast<std::size_t>(std::countr_zero(option))];
+  }
+
+  std::size_t sizeInBytes() const
+  {
+    std::size_t total{ 0 };
+    for (const auto& bitmap : m_flags) total += bitmap.sizeInBytes();
+    return total;
+  }
+
+private:
+  std::array<RoaringBitmap, 8> m_flags{};
+};
+
+int main()
+{
+  RoaringBitmap small{};
+  for (std::uint32_t v : { 1u, 5u, 70'000u, 70'001u, 4'000'000'000u }) small.add(v);
+  assert(small.cardinality() == 5 && small.contains(70'001) && !small.contains(2));
+  RoaringBitmap other{};
+  for (std::uint32_t v{ 0 }; v < 100'000; ++v) other.add(v); // dense, becomes bitset and then run containers
+  other.runOptimize();
+  assert((small & other).cardinality() == 4);
+  assert((small | other).cardinality() == 100'001);
+  assert(andNot(small, other).cardinality() == 1 && andNot(small, other).contains(4'000'000'000u));
+
+  // Run containers take values in place and combine with runs and arrays range by range. Every combination of
+  // container types is checked against std::set.
+  RoaringBitmap runs{};
+  for (std::uint32_t v{ 0 }; v < 60'000; ++v) {
+    if (v % 1'000 < 600) runs.add(v);
+  }
+  runs.runOptimize();
+  std::size_t runsSize{ runs.sizeInBytes() };
+  // 600 extends a run, 700, 59'999 and 65'535 are new runs, 0 and 1'599 are in runs already
+  for (std::uint32_t v : { 599u, 600u, 700u, 1'599u, 59'999u, 65'535u, 0u }) runs.add(v);
+  assert(runs.sizeInBytes() == runsSize + 3 * 4 && runs.contains(600) && runs.contains(65'535) && !runs.contains(601));
+  // filling the gap up to 1'000 absorbs the run of 700 and joins [0, 600] with [1'000, 1'599]
+  for (std::uint32_t v{ 601 }; v < 1'000; ++v) runs.add(v);
+  assert(runs.sizeInBytes() == runsSize + 4 && runs.cardinality() == 36'000 + 400 + 2);
+
+  auto toSet{ [](const RoaringBitmap& bitmap) {
+    std::set<std::uint32_t> values{};
+    bitmap.forEach([&values](std::uint32_t v) { values.insert(v); });
+    return values;
+  } };
+  auto randomBitmap{ [](std::uint32_t step, bool optimize) {
+    RoaringBitmap bitmap{};
+    for (std::uint32_t v{ Random::get(0u, step) }; v < 200'000; v += Random::get(1u, step)) {
+      std::uint32_t length{ Random::get(0u, 300u) };
+      for (std::uint32_t end{ v + length }; v <= end && v < 200'000; ++v) bitmap.add(v);
+    }
+    if (optimize) bitmap.runOptimize();
+    return bitmap;
+  } };
+  for (int round{ 0 }; round < 20; ++round) {
+    RoaringBitmap a{ randomBitmap(static_cast<std::uint32_t>(Random::get(2, 2'000)), round % 2 == 0) };
+    RoaringBitmap b{ randomBitmap(static_cast<std::uint32_t>(Random::get(2, 2'000)), round % 4 < 2) };
+    std::set<std::uint32_t> setA{ toSet(a) }, setB{ toSet(b) }, expected{};
+    std::set_intersection(setA.begin(), setA.end(), setB.begin(), setB.end(), std::inserter(expected, expected.end()));
+    assert(toSet(a & b) == expected);
+    expected.clear();
+    std::set_union(setA.begin(), setA.end(), setB.begin(), setB.end(), std::inserter(expected, expected.end()));
+    assert(toSet(a | b) == expected);
+    expected.clear();
+    std::set_difference(setA.begin(), setA.end(), setB.begin(), setB.end(), std::inserter(expected, expected.end()));
+    assert(toSet(andNot(a, b)) == expected && andNot(a, b).cardinality() == expected.size());
+  }
+
+  // Ten million articles. Most are viewed, few are favorited or shared, and deleted articles come in large batches.
+  constexpr std::uint32_t articleCount{ 10'000'000 };
+  std::vector<std::uint8_t> articleFlags(articleCount);
+  for (std::uint32_t id{ 0 }; id < articleCount; ++id) {
+    std::uint8_t flags{ 0 };
+    if (Random::get(1, 100) <= 90) flags |= option_viewed;
+    if (Random::get(1, 100) <= 10) flags |= option_edited;
+    if (Random::get(1, 100) <= 5) flags |= option_favorited;
+    if (Random::get(1, 100) <= 1) flags |= option_shared;
+    if (id % 1'000'000 < 50'000) flags |= option_deleted;
+    articleFlags[id] = flags;
+  }
+
+  Timer t{};
+  ArticleFlagIndex index{};
+  for (std::uint32_t id{ 0 }; id < articleCount; ++id) index.add(id, articleFlags[id]);
+  index.runOptimize();
+  std::cout << "building the index: " << t.elapsed() << " s, " << index.sizeInBytes() / 1024 << " KB\n";
+
+  // "favorited and not deleted" by scanning every article's flag byte
+  t.reset();
+  std::size_t scanned{ 0 };
+  for (std::uint8_t flags : articleFlags) {
+    scanned += (flags & option_favorited) && !(flags & option_deleted);
+  }
+  std::cout << "scan: " << t.elapsed() * 1e6 << " us\n";
+
+  t.reset();
+  RoaringBitmap favorited{ andNot(index.withFlag(option_favorited), index.withFlag(option_deleted)) };
+  std::uint64_t indexed{ favorited.cardinality() };
+  std::cout << "bitmap index: " << t.elapsed() * 1e6 << " us\n";
+  assert(indexed == scanned);
+
+  // "shared or edited, and viewed"
+  t.reset();
+  RoaringBitmap active{ (index.withFlag(option_shared) | index.withFlag(option_edited)) & index.withFlag(option_viewed) };
+  std::cout << "bitmap index (shared | edited) & viewed: " << t.elapsed() * 1e6 << " us, " << active.cardinality()
+            << " articles\n";
+
+  std::cout << scanned << " articles are favorited and not deleted\n";
+
+  return 0;
+}
@@ -0,0 +1,224 @@
+#ifndef BIT_VECTOR_H
+#define BIT_VECTOR_H
+
+#include "Bits.h"
+#include <algorithm> // for std::fill, std::upper_bound
+#include <bit> // for std::popcount, std::countr_zero
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+BitVector generalizes Storage8<bool> (class_template_spec.cpp) to any number of bits. Bits are packed into 64-bit words,
+so count() is one popcount per 64 bits and the bulk operations (&=, |=, ^=, andNot) process 64 bits per operation. Those
+loops have no dependencies between iterations, so the compiler vectorizes them (SSE/AVX with -O3 or -march=native).
+
+rank(i) (number of set bits before i) and select(k) (position of the k-th set bit) use an index built by
+buildIndex():
+- a cumulative count for every superblock of 512 bits (8 words), so rank() is one lookup plus at most 8 popcounts;
+- the superblock of every 4096th set bit, so select() binary searches the cumulative counts between two samples.
+  Sparse vectors have many superblocks between two samples, so scanning them one by one could take thousands of steps.
+The index costs 64 bits per 512 bits (12.5%). Any modification invalidates it; rank() and select() assert that it's up
+to date.
+
+Bits past size() in the last word are always zero, so counting and comparing whole words never sees garbage.
+*/
+class BitVector
+{
+public:
+  using Word = std::uint64_t;
+  static constexpr std::size_t wordBits{ 64 };
+
+  BitVector() = default;
+  explicit BitVector(std::size_t size, bool value = false) { resize(size, value); }
+
+  std::size_t size() const { return m_size; }
+  const std::vector<Word>& words() const { return m_words; }
+
+  bool get(std::size_t index) const
+  {
+    assert(index < m_size);
+    return (m_words[index / wordBits] >> (index % wordBits)) & 1;
+  }
+  bool operator[](std::size_t index) const { return get(index); }
+
+  void set(std::size_t index, bool value = true)
+  {
+    assert(index < m_size);
+    Word mask{ Word{ 1 } << (index % wordBits) };
+    if (value)
+      m_words[index / wordBits] |= mask;
+    else
+      m_words[index / wordBits] &= ~mask;
+    m_indexValid = false;
+  }
+
+  void reset(std::size_t index) { set(index, false); }
+
+  void flip(std::size_t index)
+  {
+    assert(index < m_size);
+    m_words[index / wordBits] ^= Word{ 1 } << (index % wordBits);
+    m_indexValid = false;
+  }
+
+  void push_back(bool value)
+  {
+    if (m_size % wordBits == 0) m_words.push_back(0);
+    ++m_size;
+    if (value) m_words.back() |= Word{ 1 } << ((m_size - 1) % wordBits);
+    m_indexValid = false;
+  }
+
+  void resize(std::size_t size, bool value = false)
+  {
+    std::size_t oldSize{ m_size };
+    m_words.resize((size + wordBits - 1) / wordBits, value ? ~Word{ 0 } : 0);
+    m_size = size;
+    if (value && oldSize < size && oldSize % wordBits != 0) {
+      // the tail of the old last word was zero, set the new bits in it
+      m_words[oldSize / wordBits] |= ~Word{ 0 } << (oldSize % wordBits);
+    }
+    clearTail();
+    m_indexValid = false;
+  }
+
+  void fill(bool value)
+  {
+    std::fill(m_words.begin(), m_words.end(), value ? ~Word{ 0 } : 0);
+    clearTail();
+    m_indexValid = false;
+  }
+
+  // Number of set bits
+  std::size_t count() const
+  {
+    std::size_t total{ 0 };
+    for (Word w : m_words) total += static_cast<std::size_t>(std::popcount(w));
+    return total;
+  }
+
+  BitVector& operator&=(const BitVector& other) { return combine(other, [](Word a, Word b) { return a & b; }); }
+  BitVector& operator|=(const BitVector& other) { return combine(other, [](Word a, Word b) { return a | b; }); }
+  BitVector& operator^=(const BitVector& other) { return combine(other, [](Word a, Word b) { return a ^ b; }); }
+  // Clears every bit that is set in other (this & ~other)
+  BitVector& andNot(const BitVector& other) { return combine(other, [](Word a, Word b) { return a & ~b; }); }
+
+  friend BitVector operator&(BitVector a, const BitVector& b) { return a &= b; }
+  friend BitVector operator|(BitVector a, const BitVector& b) { return a |= b; }
+  friend BitVector operator^(BitVector a, const BitVector& b) { return a ^= b; }
+
+  friend bool operator==(const BitVector& a, const BitVector& b)
+  {
+    return a.m_size == b.m_size && a.m_words == b.m_words;
+  }
+
+  // Builds the rank/select index, must be called after the last modification and before rank() or select()
+  void buildIndex()
+  {
+    std::size_t superblocks{ (m_words.size() + wordsPerSuperblock - 1) / wordsPerSuperblock };
+    m_superblockRanks.assign(superblocks + 1, 0);
+    m_selectSamples.clear();
+
+    std::size_t total{ 0 };
+    for (std::size_t s{ 0 }; s < superblocks; ++s) {
+      m_superblockRanks[s] = total;
+      std::size_t end{ std::min(m_words.size(), (s + 1) * wordsPerSuperblock) };
+      std::size_t inBlock{ 0 };
+      for (std::size_t w{ s * wordsPerSuperblock }; w < end; ++w) {
+        inBlock += static_cast<std::size_t>(std::popcount(m_words[w]));
+      }
+      // record the superblock for every set bit number that is a multiple of selectSampleRate in this block
+      while (m_selectSamples.size() * selectSampleRate < total + inBlock) m_selectSamples.push_back(s);
+      total += inBlock;
+    }
+    m_superblockRanks[superblocks] = total;
+    m_indexValid = true;
+  }
+
+  // Number of set bits in [0, index)
+  std::size_t rank(std::size_t index) const
+  {
+    assert(m_indexValid && "BitVector::rank(): call buildIndex() first");
+    assert(index <= m_size);
+    std::size_t word{ index / wordBits };
+    std::size_t superblock{ word / wordsPerSuperblock };
+    std::size_t result{ m_superblockRanks[superblock] };
+    for (std::size_t w{ superblock * wordsPerSuperblock }; w < word; ++w) {
+      result += static_cast<std::size_t>(std::popcount(m_words[w]));
+    }
+    if (index % wordBits != 0) {
+      Word mask{ (Word{ 1 } << (index % wordBits)) - 1 };
+      result += static_cast<std::size_t>(std::popcount(m_words[word] & mask));
+    }
+    return result;
+  }
+
+  // Position of the k-th set bit (0-based), k must be less than count()
+  std::size_t select(std::size_t k) const
+  {
+    assert(m_indexValid && "BitVector::select(): call buildIndex() first");
+    assert(k < m_superblockRanks.back());
+    // the sample gives a superblock at or before the answer, the next sample one at or after it. The answer is in the
+    // last superblock between them that starts with at most k set bits before it.
+    std::size_t sample{ k / selectSampleRate };
+    std::size_t first{ m_selectSamples[sample] };
+    std::size_t last{ sample + 1 < m_selectSamples.size() ? m_selectSamples[sample + 1] : m_superblockRanks.size() - 2 };
+    auto begin{ m_superblockRanks.begin() };
+    auto after{ std::upper_bound(begin + static_cast<std::ptrdiff_t>(first) + 1,
+      begin + static_cast<std::ptrdiff_t>(last) + 1, k) };
+    auto superblock{ static_cast<std::size_t>(after - begin) - 1 };
+
+    std::size_t remaining{ k - m_superblockRanks[superblock] };
+    std::size_t word{ superblock * wordsPerSuperblock };
+    for (;; ++word) {
+      auto bits{ static_cast<std::size_t>(std::popcount(m_words[word])) };
+      if (remaining < bits) break;
+      remaining -= bits;
+    }
+    return word * wordBits + selectInWord(m_words[word], remaining);
+  }
+
+private:
+  static constexpr std::size_t wordsPerSuperblock{ 8 };
+  static constexpr std::size_t selectSampleRate{ 4096 };
+
+  std::vector<Word> m_words{};
+  std::size_t m_size{ 0 };
+
+  std::vector<std::size_t> m_superblockRanks{}; // set bits before each superblock, plus the total at the end
+  std::vector<std::size_t> m_selectSamples{}; // superblock containing set bit number i * selectSampleRate
+  bool m_indexValid{ false };
+
+  void clearTail()
+  {
+    if (m_size % wordBits != 0) m_words.back() &= (Word{ 1 } << (m_size % wordBits)) - 1;
+  }
+
+  template<typename Operation> BitVector& combine(const BitVector& other, Operation operation)
+  {
+    assert(m_size == other.m_size && "BitVector: sizes differ");
+    Word* a{ m_words.data() };
+    const Word* b{ other.m_words.data() };
+    for (std::size_t i{ 0 }; i < m_words.size(); ++i) a[i] = operation(a[i], b[i]);
+    m_indexValid = false;
+    return *this;
+  }
+
+  // Position of the k-th set bit within a word
+  static std::size_t selectInWord(Word w, std::size_t k)
+  {
+#if defined(__BMI2__)
+    // pdep deposits the single bit 1 << k into the k-th set bit position of w
+    return static_cast<std::size_t>(std::countr_zero(Bits::pdep(Word{ 1 } << k, w)));
+#else
+    // Bits::pdep() would loop over every set bit of w here, this loop stops after k of them
+    // clear the k lowest set bits, then the answer is the lowest one left
+    for (; k > 0; --k) w &= w - 1;
+    return static_cast<std::size_t>(std::countr_zero(w));
+#endif
+  }
+};
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef BITS_H
+#define BITS_H
+
+#include <array>
+#include <bit> // for std::rotl, std::popcount, std::countr_zero, std::countl_zero, std::byteswap
+#include <cassert>
+#include <charconv> // for std::to_chars_result
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <system_error> // for std::errc
+#if defined(__BMI2__)
+#include <immintrin.h> // for _pdep_u64, _pext_u64
+#endif
+
+// Header-only bit manipulation primitives. Everything is constexpr, and nothing allocates, recurses or uses iostream.
+// Requires C++23 (if consteval and std::byteswap).
+namespace Bits {
+  template<std::unsigned_integral T> constexpr int digits{ std::numeric_limits<T>::digits };
+
+  // Full-width rotates, these compile to a single rol/ror instruction
+  template<std::unsigned_integral T> constexpr T rotl(T x, int shift) { return std::rotl(x, shift); }
+  template<std::unsigned_integral T> constexpr T rotr(T x, int shift) { return std::rotr(x, shift); }
+
+  // Rotates only the low Width bits, e.g. rotl<4>(0b1001u, 1) == 0b0011 (what rotl(std::bitset<4>) in O.2_2-3 does)
+  template<int Width, std::unsigned_integral T> constexpr T rotl(T x, int shift)
+  {
+    static_assert(Width > 0 && Width <= digits<T>);
+    if constexpr (Width == digits<T>) {
+      return std::rotl(x, shift);
+    } else {
+      constexpr T mask{ static_cast<T>((T{ 1 } << Width) - 1) };
+      shift = ((shift % Width) + Width) % Width;
+      x &= mask;
+      if (shift == 0) return x;
+      return static_cast<T>(((x << shift) | (x >> (Width - shift))) & mask);
+    }
+  }
+
+  template<int Width, std::unsigned_integral T> constexpr T rotr(T x, int shift) { return rotl<Width>(x, -shift); }
+
+  template<std::unsigned_integral T> constexpr int popcount(T x) { return std::popcount(x); }
+  // Number of trailing zero bits, digits<T> for 0
+  template<std::unsigned_integral T> constexpr int ctz(T x) { return std::countr_zero(x); }
+  // Number of leading zero bits, digits<T> for 0
+  template<std::unsigned_integral T> constexpr int clz(T x) { return std::countl_zero(x); }
+
+  // Portable parallel bit deposit: the low bits of source are placed, in order, at the set bit positions of mask
+  constexpr std::uint64_t pdepPortable(std::uint64_t source, std::uint64_t mask)
+  {
+    std::uint64_t result{ 0 };
+    for (std::uint64_t bit{ 1 }; mask != 0; bit <<= 1) {
+      if (source & bit) result |= mask & (~mask + 1); // lowest set bit of mask
+      mask &= mask - 1;
+    }
+    return result;
+  }
+
+  // Portable parallel bit extract: the bits of source at the set bit positions of mask are packed into the low bits
+  constexpr std::uint64_t pextPortable(std::uint64_t source, std::uint64_t mask)
+  {
+    std::uint64_t result{ 0 };
+    for (std::uint64_t bit{ 1 }; mask != 0; bit <<= 1) {
+      if (source & mask & (~mask + 1)) result |= bit;
+      mask &= mask - 1;
+    }
+    return result;
+  }
+
+  // pdep/pext use the BMI2 instructions when the target has them (-mbmi2 or -march=native on Haswell or newer), and
+  // the portable loops during constant evaluation or on other targets
+  constexpr std::uint64_t pdep(std::uint64_t source, std::uint64_t mask)
+  {
+    if consteval {
+      return pdepPortable(source, mask);
+    } else {
+#if defined(__BMI2__)
+      return _pdep_u64(source, mask);
+#else
+      return pdepPortable(source, mask);
+#endif
+    }
+  }
+
+  constexpr std::uint64_t pext(std::uint64_t source, std::uint64_t mask)
+  {
+    if consteval {
+      return pextPortable(source, mask);
+    } else {
+#if defined(__BMI2__)
+      return _pext_u64(source, mask);
+#else
+      return pextPortable(source, mask);
+#endif
+    }
+  }
+
+  // Reverses the order of the bits: swap neighbouring bits, then pairs, then nibbles, then the bytes in one instruction
+  template<std::unsigned_integral T> constexpr T reverse(T x)
+  {
+    std::uint64_t v{ x };
+    v = ((v >> 1) & 0x5555555555555555) | ((v & 0x5555555555555555) << 1);
+    v = ((v >> 2) & 0x3333333333333333) | ((v & 0x3333333333333333) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0F) | ((v & 0x0F0F0F0F0F0F0F0F) << 4);
+    v = std::byteswap(v);
+    return static_cast<T>(v >> (64 - digits<T>));
+  }
+
+  namespace detail {
+    // The 8 characters for every byte value, most significant bit first
+    constexpr std::array<std::array<char, 8>, 256> binaryDigits{ [] {
+      std::array<std::array<char, 8>, 256> table{};
+      for (std::size_t value{ 0 }; value < 256; ++value) {
+        for (std::size_t bit{ 0 }; bit < 8; ++bit) {
+          table[value][7 - bit] = static_cast<char>('0' + ((value >> bit) & 1));
+        }
+      }
+      return table;
+    }() };
+  } // namespace detail
+
+  /*
+  Writes the low `width` bits of value (most significant first, with leading zeros) into [first, last), like
+  std::bitset<width>::to_string() but without allocating. Whole bytes are copied from a lookup table, instead of
+  computing one bit per division or per recursive call. Use width = std::bit_width(value) to skip the leading zeros.
+  */
+  template<std::unsigned_integral T>
+  constexpr std::to_chars_result formatBinary(char* first, char* last, T value, int width = digits<T>)
+  {
+    assert(width >= 0 && width <= digits<T>);
+    if (last - first < width) return { last, std::errc::value_too_large };
+
+    char* out{ first + width };
+    int remaining{ width };
+    for (; remaining >= 8; remaining -= 8) {
+      out -= 8;
+      const auto& chars{ detail::binaryDigits[static_cast<std::size_t>(value & 0xFF)] };
+      for (std::size_t i{ 0 }; i < 8; ++i) out[i] = chars[i];
+      value = static_cast<T>(value >> 8); // value is promoted to int for narrow types, so shifting by 8 is fine
+    }
+    for (; remaining > 0; --remaining) {
+      *--out = static_cast<char>('0' + (value & 1));
+      value = static_cast<T>(value >> 1);
+    }
+    return { first + width, std::errc{} };
+  }
+} // namespace Bits
+
+#endif
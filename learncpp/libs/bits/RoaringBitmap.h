@@ -0,0 +1,462 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <algorithm> // for std::lower_bound, std::set_intersection, ...
+#include <bit> // for std::popcount, std::countr_zero
+#include <cstddef>
+#include <cstdint>
+#include <iterator> // for std::back_inserter
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/*
+Compressed bitmap of 32-bit values in the style of Roaring bitmaps (https://roaringbitmap.org).
+
+Values are split by their high 16 bits into chunks of 65536. Every non-empty chunk has a container for the low 16 bits,
+and the container type depends on the density of the chunk:
+- Array: sorted std::uint16_t values, used for up to 4096 values (at most 8 KB);
+- Bitset: 1024 64-bit words (always 8 KB), used for more than 4096 values;
+- Run: sorted [start, start + length] ranges, created by runOptimize() when that's the smallest representation (long
+  stretches of consecutive values, e.g. articles deleted in bulk).
+Operations work container by container: two arrays are merged, an array is checked against a bitset value by value, and
+two bitsets are combined 64 bits at a time. Two run containers are merged range by range, and so is a run container with
+an array, which is turned into runs first. Only a run container combined with a bitset is expanded into a bitset.
+Results are converted back to an array when they have 4096 values or fewer, and results of runs stay runs while that's
+the smallest representation.
+*/
+class RoaringBitmap
+{
+public:
+  void add(std::uint32_t value)
+  {
+    auto high{ static_cast<std::uint16_t>(value >> 16) };
+    auto low{ static_cast<std::uint16_t>(value & 0xFFFF) };
+    auto found{ std::lower_bound(m_keys.begin(), m_keys.end(), high) };
+    auto index{ static_cast<std::size_t>(found - m_keys.begin()) };
+    if (found == m_keys.end() || *found != high) {
+      m_keys.insert(found, high);
+      m_containers.insert(m_containers.begin() + static_cast<std::ptrdiff_t>(index), Array{});
+    }
+
+    Container& container{ m_containers[index] };
+    if (auto* array{ std::get_if<Array>(&container) }) {
+      // appending in increasing order, the common case when building an index, doesn't need a search
+      if (array->empty() || array->back() < low) {
+        array->push_back(low);
+      } else if (auto position{ std::lower_bound(array->begin(), array->end(), low) }; *position != low) {
+        array->insert(position, low);
+      }
+      if (array->size() > arrayMaxSize) container = toBitset(container);
+    } else if (auto* bitset{ std::get_if<Bitset>(&container) }) {
+      bitset->set(low);
+    } else {
+      addToRun(std::get<Run>(container), low);
+    }
+  }
+
+  bool contains(std::uint32_t value) const
+  {
+    auto high{ static_cast<std::uint16_t>(value >> 16) };
+    auto found{ std::lower_bound(m_keys.begin(), m_keys.end(), high) };
+    if (found == m_keys.end() || *found != high) return false;
+    return containerContains(m_containers[static_cast<std::size_t>(found - m_keys.begin())],
+      static_cast<std::uint16_t>(value & 0xFFFF));
+  }
+
+  std::uint64_t cardinality() const
+  {
+    std::uint64_t total{ 0 };
+    for (const auto& c : m_containers) total += containerCardinality(c);
+    return total;
+  }
+
+  // Converts every container to the smallest of the three representations
+  void runOptimize()
+  {
+    for (auto& container : m_containers) {
+      Run run{ toRun(container) };
+      std::size_t runBytes{ run.size() * sizeof(Run::value_type) };
+      std::size_t cardinality{ containerCardinality(container) };
+      std::size_t otherBytes{ cardinality <= arrayMaxSize ? cardinality * sizeof(std::uint16_t) : bitsetBytes };
+      if (runBytes < otherBytes) {
+        container = std::move(run);
+      } else if (std::holds_alternative<Run>(container)) {
+        container = normalize(toBitset(container));
+      }
+    }
+  }
+
+  // Approximate memory used by the containers
+  std::size_t sizeInBytes() const
+  {
+    std::size_t total{ m_keys.size() * sizeof(std::uint16_t) };
+    for (const auto& c : m_containers) {
+      if (auto* array{ std::get_if<Array>(&c) }) total += array->size() * sizeof(std::uint16_t);
+      else if (auto* run{ std::get_if<Run>(&c) }) total += run->size() * sizeof(Run::value_type);
+      else total += bitsetBytes;
+    }
+    return total;
+  }
+
+  // Calls function(value) for every value in increasing order
+  template<typename Function> void forEach(Function function) const
+  {
+    for (std::size_t i{ 0 }; i < m_keys.size(); ++i) {
+      std::uint32_t high{ static_cast<std::uint32_t>(m_keys[i]) << 16 };
+      std::visit(
+        [&](const auto& c) {
+          using T = std::decay_t<decltype(c)>;
+          if constexpr (std::is_same_v<T, Array>) {
+            for (std::uint16_t low : c) function(high | low);
+          } else if constexpr (std::is_same_v<T, Bitset>) {
+            for (std::size_t w{ 0 }; w < Bitset::wordCount; ++w) {
+              for (std::uint64_t word{ c.words[w] }; word != 0; word &= word - 1) {
+                function(high | static_cast<std::uint32_t>(w * 64 + static_cast<std::size_t>(std::countr_zero(word))));
+              }
+            }
+          } else {
+            for (auto [start, length] : c) {
+              for (std::uint32_t v{ start }; v <= std::uint32_t{ start } + length; ++v) function(high | v);
+            }
+          }
+        },
+        m_containers[i]);
+    }
+  }
+
+  friend RoaringBitmap operator&(const RoaringBitmap& a, const RoaringBitmap& b)
+  {
+    return combine(a, b, Operation::intersection);
+  }
+  friend RoaringBitmap operator|(const RoaringBitmap& a, const RoaringBitmap& b)
+  {
+    return combine(a, b, Operation::union_);
+  }
+  // Values in a but not in b
+  friend RoaringBitmap andNot(const RoaringBitmap& a, const RoaringBitmap& b)
+  {
+    return combine(a, b, Operation::difference);
+  }
+
+private:
+  static constexpr std::size_t arrayMaxSize{ 4096 };
+  static constexpr std::size_t bitsetBytes{ 65536 / 8 };
+
+  using Array = std::vector<std::uint16_t>;
+  using Run = std::vector<std::pair<std::uint16_t, std::uint16_t>>; // start and length - 1, so a run can cover 65536
+
+  struct Bitset
+  {
+    static constexpr std::size_t wordCount{ 65536 / 64 };
+    // on the heap, so that array and run containers in the same std::variant don't take 8 KB each
+    std::vector<std::uint64_t> words{ std::vector<std::uint64_t>(wordCount) };
+    std::uint32_t cardinality{ 0 };
+
+    bool test(std::uint16_t low) const { return (words[low / 64] >> (low % 64)) & 1; }
+    void set(std::uint16_t low)
+    {
+      std::uint64_t mask{ std::uint64_t{ 1 } << (low % 64) };
+      cardinality += (words[low / 64] & mask) == 0;
+      words[low / 64] |= mask;
+    }
+    void clear(std::uint16_t low)
+    {
+      std::uint64_t mask{ std::uint64_t{ 1 } << (low % 64) };
+      cardinality -= (words[low / 64] & mask) != 0;
+      words[low / 64] &= ~mask;
+    }
+  };
+
+  using Container = std::variant<Array, Bitset, Run>;
+
+  enum class Operation {
+    intersection,
+    union_,
+    difference,
+  };
+
+  std::vector<std::uint16_t> m_keys{}; // high 16 bits, sorted
+  std::vector<Container> m_containers{}; // m_containers[i] holds the low 16 bits of the values in chunk m_keys[i]
+
+  // Extends the run that ends right before low or starts right after it, merging the two if low fills the gap
+  static void addToRun(Run& run, std::uint16_t low)
+  {
+    // the first run that starts after low
+    auto next{ std::upper_bound(
+      run.begin(), run.end(), low, [](std::uint16_t value, const auto& r) { return value < r.first; }) };
+    bool joinsNext{ next != run.end() && std::uint32_t{ low } + 1 == next->first };
+    if (next != run.begin()) {
+      auto previous{ std::prev(next) };
+      std::uint32_t end{ std::uint32_t{ previous->first } + previous->second };
+      if (low <= end) return;
+      if (low == end + 1) {
+        previous->second = static_cast<std::uint16_t>(previous->second + 1 + (joinsNext ? next->second + 1 : 0));
+        if (joinsNext) run.erase(next);
+        return;
+      }
+    }
+    if (joinsNext) {
+      next->first = low;
+      ++next->second;
+    } else {
+      run.emplace(next, low, std::uint16_t{ 0 });
+    }
+  }
+
+  static bool containerContains(const Container& container, std::uint16_t low)
+  {
+    if (auto* array{ std::get_if<Array>(&container) }) return std::binary_search(array->begin(), array->end(), low);
+    if (auto* bitset{ std::get_if<Bitset>(&container) }) return bitset->test(low);
+    const Run& run{ std::get<Run>(container) };
+    // the last run that starts at or before low
+    auto found{ std::upper_bound(
+      run.begin(), run.end(), low, [](std::uint16_t value, const auto& r) { return value < r.first; }) };
+    if (found == run.begin()) return false;
+    --found;
+    return low <= found->first + found->second;
+  }
+
+  static std::size_t containerCardinality(const Container& container)
+  {
+    if (auto* array{ std::get_if<Array>(&container) }) return array->size();
+    if (auto* bitset{ std::get_if<Bitset>(&container) }) return bitset->cardinality;
+    std::size_t total{ 0 };
+    for (auto [start, length] : std::get<Run>(container)) total += std::size_t{ length } + 1;
+    return total;
+  }
+
+  static Bitset toBitset(const Container& container)
+  {
+    if (auto* bitset{ std::get_if<Bitset>(&container) }) return *bitset;
+    Bitset result{};
+    if (auto* array{ std::get_if<Array>(&container) }) {
+      for (std::uint16_t low : *array) result.set(low);
+    } else {
+      for (auto [start, length] : std::get<Run>(container)) {
+        for (std::uint32_t v{ start }; v <= std::uint32_t{ start } + length; ++v) result.set(static_cast<std::uint16_t>(v));
+      }
+    }
+    return result;
+  }
+
+  static Run toRun(const Container& container)
+  {
+    if (auto* run{ std::get_if<Run>(&container) }) return *run;
+    Run result{};
+    auto append{ [&result](std::uint16_t low) {
+      if (!result.empty() && std::uint32_t{ result.back().first } + result.back().second + 1 == low) {
+        ++result.back().second;
+      } else {
+        result.emplace_back(low, std::uint16_t{ 0 });
+      }
+    } };
+    if (auto* array{ std::get_if<Array>(&container) }) {
+      for (std::uint16_t low : *array) append(low);
+    } else {
+      const Bitset& bitset{ std::get<Bitset>(container) };
+      for (std::size_t w{ 0 }; w < Bitset::wordCount; ++w) {
+        for (std::uint64_t word{ bitset.words[w] }; word != 0; word &= word - 1) {
+          append(static_cast<std::uint16_t>(w * 64 + static_cast<std::size_t>(std::countr_zero(word))));
+        }
+      }
+    }
+    return result;
+  }
+
+  // Sparse bitsets become arrays again
+  static Container normalize(const Bitset& bitset)
+  {
+    if (bitset.cardinality > arrayMaxSize) return bitset;
+    Array array{};
+    array.reserve(bitset.cardinality);
+    for (std::size_t w{ 0 }; w < Bitset::wordCount; ++w) {
+      for (std::uint64_t word{ bitset.words[w] }; word != 0; word &= word - 1) {
+        array.push_back(static_cast<std::uint16_t>(w * 64 + static_cast<std::size_t>(std::countr_zero(word))));
+      }
+    }
+    return array;
+  }
+
+  // Runs stay runs if they're smaller than the array or bitset that holds the same values, like in runOptimize()
+  static Container normalize(Run&& run)
+  {
+    std::size_t cardinality{ 0 };
+    for (auto [start, length] : run) cardinality += std::size_t{ length } + 1;
+    std::size_t otherBytes{ cardinality <= arrayMaxSize ? cardinality * sizeof(std::uint16_t) : bitsetBytes };
+    if (run.size() * sizeof(Run::value_type) < otherBytes) return std::move(run);
+    if (cardinality > arrayMaxSize) return toBitset(std::move(run));
+    Array array{};
+    array.reserve(cardinality);
+    for (auto [start, length] : run) {
+      for (std::uint32_t v{ start }; v <= std::uint32_t{ start } + length; ++v) {
+        array.push_back(static_cast<std::uint16_t>(v));
+      }
+    }
+    return array;
+  }
+
+  static Container normalize(Array&& array)
+  {
+    if (array.size() <= arrayMaxSize) return std::move(array);
+    Bitset bitset{};
+    for (std::uint16_t low : array) bitset.set(low);
+    return bitset;
+  }
+
+  // Merges two lists of sorted, disjoint runs. Ranges are [start, end] in 32 bits, so that end + 1 doesn't wrap.
+  static Run combineRuns(const Run& a, const Run& b, Operation operation)
+  {
+    Run result{};
+    auto push{ [&result](std::uint32_t start, std::uint32_t end) {
+      result.emplace_back(static_cast<std::uint16_t>(start), static_cast<std::uint16_t>(end - start));
+    } };
+    auto endOf{ [](const auto& r) { return std::uint32_t{ r.first } + r.second; } };
+
+    if (operation == Operation::intersection) {
+      for (std::size_t i{ 0 }, j{ 0 }; i < a.size() && j < b.size();) {
+        std::uint32_t start{ std::max(a[i].first, b[j].first) };
+        std::uint32_t end{ std::min(endOf(a[i]), endOf(b[j])) };
+        if (start <= end) push(start, end);
+        // the run that ends first can't overlap anything else
+        if (endOf(a[i]) < endOf(b[j])) ++i;
+        else ++j;
+      }
+    } else if (operation == Operation::union_) {
+      std::uint32_t start{ 0 };
+      std::uint32_t end{ 0 };
+      bool open{ false };
+      for (std::size_t i{ 0 }, j{ 0 }; i < a.size() || j < b.size();) {
+        // the run that starts first, overlapping and adjacent runs are joined
+        bool takeA{ j == b.size() || (i < a.size() && a[i].first < b[j].first) };
+        const auto& next{ takeA ? a[i++] : b[j++] };
+        if (open && next.first <= end + 1) {
+          end = std::max(end, endOf(next));
+        } else {
+          if (open) push(start, end);
+          start = next.first;
+          end = endOf(next);
+          open = true;
+        }
+      }
+      if (open) push(start, end);
+    } else {
+      std::size_t j{ 0 };
+      for (const auto& r : a) {
+        std::uint32_t start{ r.first };
+        std::uint32_t end{ endOf(r) };
+        // runs of b that end before this run can't overlap the following ones either
+        while (j < b.size() && endOf(b[j]) < start) ++j;
+        for (std::size_t k{ j }; k < b.size() && b[k].first <= end && start <= end; ++k) {
+          if (b[k].first > start) push(start, b[k].first - 1u);
+          start = endOf(b[k]) + 1;
+        }
+        if (start <= end) push(start, end);
+      }
+    }
+    return result;
+  }
+
+  static Container combineContainers(const Container& a, const Container& b, Operation operation)
+  {
+    const Array* arrayA{ std::get_if<Array>(&a) };
+    const Array* arrayB{ std::get_if<Array>(&b) };
+
+    if (arrayA && arrayB) {
+      Array result{};
+      if (operation == Operation::intersection) {
+        std::set_intersection(arrayA->begin(), arrayA->end(), arrayB->begin(), arrayB->end(), std::back_inserter(result));
+      } else if (operation == Operation::union_) {
+        std::set_union(arrayA->begin(), arrayA->end(), arrayB->begin(), arrayB->end(), std::back_inserter(result));
+      } else {
+        std::set_difference(arrayA->begin(), arrayA->end(), arrayB->begin(), arrayB->end(), std::back_inserter(result));
+      }
+      return normalize(std::move(result));
+    }
+
+    // one small side: check each of its values against the other container instead of expanding anything
+    if (arrayA && operation != Operation::union_) {
+      bool keepContained{ operation == Operation::intersection };
+      Array result{};
+      if (const Run* runB{ std::get_if<Run>(&b) }) {
+        // both sides are sorted, so walk them together instead of searching the runs for every value
+        auto run{ runB->begin() };
+        for (std::uint16_t low : *arrayA) {
+          while (run != runB->end() && run->first + run->second < low) ++run;
+          bool contained{ run != runB->end() && run->first <= low };
+          if (contained == keepContained) result.push_back(low);
+        }
+      } else {
+        for (std::uint16_t low : *arrayA) {
+          if (containerContains(b, low) == keepContained) result.push_back(low);
+        }
+      }
+      return result;
+    }
+    if (arrayB && operation == Operation::intersection) return combineContainers(b, a, operation);
+
+    // runs with runs, or with an array turned into runs, without expanding either side into 8 KB
+    const Run* runA{ std::get_if<Run>(&a) };
+    const Run* runB{ std::get_if<Run>(&b) };
+    if (runA && runB) return normalize(combineRuns(*runA, *runB, operation));
+    if (runA && arrayB) return normalize(combineRuns(*runA, toRun(b), operation));
+    if (arrayA && runB) return normalize(combineRuns(toRun(a), *runB, operation));
+
+    Bitset result{ toBitset(a) };
+    if (arrayB) {
+      for (std::uint16_t low : *arrayB) {
+        if (operation == Operation::union_) result.set(low);
+        else result.clear(low);
+      }
+    } else {
+      Bitset other{ toBitset(b) };
+      std::uint32_t cardinality{ 0 };
+      for (std::size_t w{ 0 }; w < Bitset::wordCount; ++w) {
+        std::uint64_t word{ result.words[w] };
+        if (operation == Operation::intersection) word &= other.words[w];
+        else if (operation == Operation::union_) word |= other.words[w];
+        else word &= ~other.words[w];
+        result.words[w] = word;
+        cardinality += static_cast<std::uint32_t>(std::popcount(word));
+      }
+      result.cardinality = cardinality;
+    }
+    return normalize(result);
+  }
+
+  static RoaringBitmap combine(const RoaringBitmap& a, const RoaringBitmap& b, Operation operation)
+  {
+    RoaringBitmap result{};
+    std::size_t i{ 0 };
+    std::size_t j{ 0 };
+    // merge the sorted key lists
+    while (i < a.m_keys.size() || j < b.m_keys.size()) {
+      bool takeA{ j == b.m_keys.size() || (i < a.m_keys.size() && a.m_keys[i] < b.m_keys[j]) };
+      bool takeB{ i == a.m_keys.size() || (j < b.m_keys.size() && b.m_keys[j] < a.m_keys[i]) };
+      if (takeA) {
+        // only in a
+        if (operation != Operation::intersection) result.append(a.m_keys[i], a.m_containers[i]);
+        ++i;
+      } else if (takeB) {
+        // only in b
+        if (operation == Operation::union_) result.append(b.m_keys[j], b.m_containers[j]);
+        ++j;
+      } else {
+        Container combined{ combineContainers(a.m_containers[i], b.m_containers[j], operation) };
+        if (containerCardinality(combined) > 0) result.append(a.m_keys[i], std::move(combined));
+        ++i;
+        ++j;
+      }
+    }
+    return result;
+  }
+
+  void append(std::uint16_t key, Container container)
+  {
+    m_keys.push_back(key);
+    m_containers.push_back(std::move(container));
+  }
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef CONCURRENT_STRING_MAP_H
+#define CONCURRENT_STRING_MAP_H
+
+#include "FlatStringMap.h"
+#include <bit> // for std::has_single_bit
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // for std::hash
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+Thread-safe map from strings to V for many writer threads. Keys are spread over a power-of-two number of shards by
+their hash, and every shard is a FlatStringMap with its own std::shared_mutex. Threads that update different shards
+never wait for each other, and readers of the same shard share the lock.
+
+There is no operator[] returning V&, since the reference would outlive the lock. update() runs a function on the value
+while the shard is locked instead (an upsert: the value is value-initialized first if the key is new).
+
+merge() sorts a batch by shard and takes every shard's lock once for all of its entries.
+
+forEach() and snapshot() lock every shard (shared, always in the same order, so they can't deadlock with each other)
+before reading any of them, so they see the state at a single point in time: no update is half-visible.
+*/
+template<typename V> class ConcurrentStringMap
+{
+public:
+  explicit ConcurrentStringMap(std::size_t shardCount = 64)
+    : m_shardCount{ shardCount }, m_shards{ std::make_unique<Shard[]>(shardCount) }
+  {
+    assert(std::has_single_bit(shardCount) && "ConcurrentStringMap: shardCount must be a power of two");
+  }
+
+  // Calls function(V&) with the shard locked
+  template<typename Function> void update(std::string_view key, Function function)
+  {
+    Shard& shard{ shardFor(key) };
+    std::unique_lock lock{ shard.mutex };
+    function(shard.map[key]);
+  }
+
+  void set(std::string_view key, const V& value)
+  {
+    update(key, [&value](V& v) { v = value; });
+  }
+
+  std::optional<V> get(std::string_view key) const
+  {
+    const Shard& shard{ shardFor(key) };
+    std::shared_lock lock{ shard.mutex };
+    if (const V* value{ shard.map.find(key) }) return *value;
+    return std::nullopt;
+  }
+
+  bool erase(std::string_view key)
+  {
+    Shard& shard{ shardFor(key) };
+    std::unique_lock lock{ shard.mutex };
+    return shard.map.erase(key);
+  }
+
+  // Sets every key of the batch, locking each shard once
+  void merge(const std::vector<std::pair<std::string, V>>& batch)
+  {
+    std::vector<std::vector<const std::pair<std::string, V>*>> byShard(m_shardCount);
+    for (const auto& entry : batch) byShard[shardIndex(entry.first)].push_back(&entry);
+
+    for (std::size_t s{ 0 }; s < m_shardCount; ++s) {
+      if (byShard[s].empty()) continue;
+      std::unique_lock lock{ m_shards[s].mutex };
+      for (const auto* entry : byShard[s]) m_shards[s].map[entry->first] = entry->second;
+    }
+  }
+
+  std::size_t size() const
+  {
+    return withAllShardsLocked([this] {
+      std::size_t total{ 0 };
+      for (std::size_t s{ 0 }; s < m_shardCount; ++s) total += m_shards[s].map.size();
+      return total;
+    });
+  }
+
+  // Calls function(key, value) for every element of a consistent snapshot, writers wait until it returns
+  template<typename Function> void forEach(Function function) const
+  {
+    withAllShardsLocked([&] {
+      for (std::size_t s{ 0 }; s < m_shardCount; ++s) m_shards[s].map.forEach(function);
+      return 0;
+    });
+  }
+
+  // Copies a consistent snapshot, writers only wait while it's being copied
+  std::vector<std::pair<std::string, V>> snapshot() const
+  {
+    std::vector<std::pair<std::string, V>> result{};
+    forEach([&result](std::string_view key, const V& value) { result.emplace_back(key, value); });
+    return result;
+  }
+
+private:
+  // on its own cache line, so threads locking neighbouring shards don't slow each other down
+  struct alignas(64) Shard
+  {
+    mutable std::shared_mutex mutex{};
+    FlatStringMap<V> map{};
+  };
+
+  std::size_t m_shardCount{};
+  std::unique_ptr<Shard[]> m_shards{};
+
+  std::size_t shardIndex(std::string_view key) const
+  {
+    // FlatStringMap uses the low bits of its own hash, use the high bits of a differently mixed one here
+    std::uint64_t h{ std::hash<std::string_view>{}(key) * 0x9E3779B97F4A7C15 };
+    return static_cast<std::size_t>(h >> 32) & (m_shardCount - 1);
+  }
+
+  Shard& shardFor(std::string_view key) { return m_shards[shardIndex(key)]; }
+  const Shard& shardFor(std::string_view key) const { return m_shards[shardIndex(key)]; }
+
+  template<typename Function> auto withAllShardsLocked(Function function) const
+  {
+    std::vector<std::shared_lock<std::shared_mutex>> locks{};
+    locks.reserve(m_shardCount);
+    for (std::size_t s{ 0 }; s < m_shardCount; ++s) locks.emplace_back(m_shards[s].mutex);
+    return function();
+  }
+};
+
+#endif
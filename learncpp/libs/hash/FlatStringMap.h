@@ -0,0 +1,229 @@
+#ifndef FLAT_STRING_MAP_H
+#define FLAT_STRING_MAP_H
+
+#include "../intern/StringArena.h"
+#include <bit> // for std::countr_zero, std::bit_ceil
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // for std::hash
+#include <string_view>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+Open-addressing hash map from strings to V with a Swiss table layout (https://abseil.io/about/design/swisstables).
+
+Slots are split into groups of 16. Every slot has a control byte: empty, deleted, or the low 7 bits of the key's hash
+when the slot is full. A lookup hashes the key once, picks a group from the high bits of the hash and compares all 16
+control bytes with the 7-bit tag in one SSE2 instruction. Only the slots whose tag matches (1 in 128 by chance) have
+their keys compared. An empty slot in the group ends the search, otherwise the next group is probed.
+
+Keys are copied into a StringArena once, when they're first inserted, and slots keep a std::string_view into it.
+Lookups take a std::string_view and never allocate.
+
+Like the std::vector-based GradeMap, inserting can move the values, so references returned by operator[] are
+invalidated by the next insertion.
+*/
+template<typename V> class FlatStringMap
+{
+public:
+  FlatStringMap() = default;
+  explicit FlatStringMap(std::size_t expectedSize) { reserve(expectedSize); }
+
+  // The defaults would copy the sizes and leave the vectors empty, so a moved-from map would probe a table with no
+  // slots. A moved-from map is empty and usable again.
+  FlatStringMap(FlatStringMap&& other) noexcept
+    : m_control{ std::move(other.m_control) }, m_slots{ std::move(other.m_slots) },
+      m_size{ std::exchange(other.m_size, 0) }, m_growthLeft{ std::exchange(other.m_growthLeft, 0) },
+      m_arena{ std::move(other.m_arena) }
+  {}
+
+  FlatStringMap& operator=(FlatStringMap&& other) noexcept
+  {
+    if (&other == this) return *this;
+    m_control = std::exchange(other.m_control, {});
+    m_slots = std::exchange(other.m_slots, {});
+    m_size = std::exchange(other.m_size, 0);
+    m_growthLeft = std::exchange(other.m_growthLeft, 0);
+    m_arena = std::move(other.m_arena);
+    return *this;
+  }
+
+  // Like std::map::operator[]: inserts a value-initialized V if the key isn't there yet
+  V& operator[](std::string_view key)
+  {
+    std::size_t hash{ hashOf(key) };
+    if (std::size_t index{ findIndex(key, hash) }; index != npos) return m_slots[index].value;
+    return insertNew(key, hash).value;
+  }
+
+  V* find(std::string_view key)
+  {
+    std::size_t index{ findIndex(key, hashOf(key)) };
+    return index == npos ? nullptr : &m_slots[index].value;
+  }
+
+  const V* find(std::string_view key) const
+  {
+    std::size_t index{ findIndex(key, hashOf(key)) };
+    return index == npos ? nullptr : &m_slots[index].value;
+  }
+
+  bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+  bool erase(std::string_view key)
+  {
+    std::size_t index{ findIndex(key, hashOf(key)) };
+    if (index == npos) return false;
+    // the slot can't become empty, since that would end the probe sequence of keys placed after it
+    m_control[index] = deletedSlot;
+    m_slots[index] = Slot{};
+    --m_size;
+    return true;
+  }
+
+  std::size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  void reserve(std::size_t count)
+  {
+    // keep the load factor at or below 7/8
+    std::size_t needed{ std::bit_ceil((count * 8 + 6) / 7) };
+    if (needed > m_slots.size()) rehash(needed < groupSize ? groupSize : needed);
+  }
+
+  // Calls function(key, value) for every element, in no particular order
+  template<typename Function> void forEach(Function function) const
+  {
+    for (std::size_t i{ 0 }; i < m_slots.size(); ++i) {
+      if (isFull(m_control[i])) function(m_slots[i].key, m_slots[i].value);
+    }
+  }
+
+private:
+  static constexpr std::size_t groupSize{ 16 };
+  static constexpr std::size_t npos{ static_cast<std::size_t>(-1) };
+  static constexpr std::int8_t emptySlot{ -128 }; // 0b1000'0000
+  static constexpr std::int8_t deletedSlot{ -2 }; // 0b1111'1110
+
+  struct Slot
+  {
+    std::string_view key{};
+    V value{};
+  };
+
+  std::vector<std::int8_t> m_control{}; // one byte per slot, full slots hold a 7-bit tag (0..127)
+  std::vector<Slot> m_slots{};
+  std::size_t m_size{ 0 };
+  std::size_t m_growthLeft{ 0 }; // inserts into empty slots left before the table must grow
+
+  StringArena m_arena{};
+
+  static bool isFull(std::int8_t control) { return control >= 0; }
+
+  static std::size_t hashOf(std::string_view key)
+  {
+    // std::hash may be the identity-like for short strings on some implementations, mix the bits so the tag and the
+    // group index are independent
+    std::uint64_t h{ std::hash<std::string_view>{}(key) };
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h);
+  }
+
+  static std::int8_t tagOf(std::size_t hash) { return static_cast<std::int8_t>(hash & 0x7F); }
+
+  std::size_t groupMask() const { return m_slots.size() / groupSize - 1; }
+
+  // Bit i is set if control byte i of the group equals value
+  std::uint32_t match(std::size_t group, std::int8_t value) const
+  {
+    const std::int8_t* control{ m_control.data() + group * groupSize };
+#if defined(__SSE2__)
+    __m128i bytes{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(control)) };
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value))));
+#else
+    std::uint32_t mask{ 0 };
+    for (std::size_t i{ 0 }; i < groupSize; ++i) mask |= static_cast<std::uint32_t>(control[i] == value) << i;
+    return mask;
+#endif
+  }
+
+  // Bit i is set if slot i of the group is empty or deleted (the sign bit of the control byte is set)
+  std::uint32_t matchAvailable(std::size_t group) const
+  {
+    const std::int8_t* control{ m_control.data() + group * groupSize };
+#if defined(__SSE2__)
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control))));
+#else
+    std::uint32_t mask{ 0 };
+    for (std::size_t i{ 0 }; i < groupSize; ++i) mask |= static_cast<std::uint32_t>(!isFull(control[i])) << i;
+    return mask;
+#endif
+  }
+
+  std::size_t findIndex(std::string_view key, std::size_t hash) const
+  {
+    if (m_slots.empty()) return npos;
+    std::int8_t tag{ tagOf(hash) };
+    std::size_t group{ (hash >> 7) & groupMask() };
+    // triangular probing visits every group exactly once when the group count is a power of two
+    for (std::size_t step{ 1 };; ++step) {
+      for (std::uint32_t candidates{ match(group, tag) }; candidates != 0; candidates &= candidates - 1) {
+        std::size_t index{ group * groupSize + static_cast<std::size_t>(std::countr_zero(candidates)) };
+        if (m_slots[index].key == key) return index;
+      }
+      if (match(group, emptySlot) != 0) return npos;
+      group = (group + step) & groupMask();
+    }
+  }
+
+  Slot& insertNew(std::string_view key, std::size_t hash)
+  {
+    if (m_growthLeft == 0) {
+      // if most of the used slots are deleted ones, rehashing at the same size is enough to clean them up
+      std::size_t capacity{ m_slots.size() };
+      rehash(capacity == 0 ? groupSize : (m_size >= capacity / 2 ? capacity * 2 : capacity));
+    }
+    std::size_t index{ findAvailable(hash) };
+    if (m_control[index] == emptySlot) --m_growthLeft;
+    m_control[index] = tagOf(hash);
+    m_slots[index].key = m_arena.store(key);
+    ++m_size;
+    return m_slots[index];
+  }
+
+  // First empty or deleted slot in the probe sequence of hash
+  std::size_t findAvailable(std::size_t hash) const
+  {
+    std::size_t group{ (hash >> 7) & groupMask() };
+    for (std::size_t step{ 1 };; ++step) {
+      if (std::uint32_t available{ matchAvailable(group) }; available != 0) {
+        return group * groupSize + static_cast<std::size_t>(std::countr_zero(available));
+      }
+      group = (group + step) & groupMask();
+    }
+  }
+
+  void rehash(std::size_t capacity)
+  {
+    std::vector<std::int8_t> oldControl{ std::exchange(m_control, std::vector<std::int8_t>(capacity, emptySlot)) };
+    std::vector<Slot> oldSlots{ std::exchange(m_slots, std::vector<Slot>(capacity)) };
+    m_growthLeft = capacity / 8 * 7 - m_size;
+    // the keys are already in the arena, only the views and values move
+    for (std::size_t i{ 0 }; i < oldSlots.size(); ++i) {
+      if (!isFull(oldControl[i])) continue;
+      std::size_t hash{ hashOf(oldSlots[i].key) };
+      std::size_t index{ findAvailable(hash) };
+      m_control[index] = tagOf(hash);
+      m_slots[index] = std::move(oldSlots[i]);
+    }
+  }
+};
+
+#endif
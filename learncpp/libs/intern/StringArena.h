@@ -0,0 +1,70 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <cstddef>
+#include <cstring> // for std::memcpy
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+Owns copies of strings. store() copies the characters into 64 KB blocks and returns a view of the copy. Blocks are
+never moved or freed before the arena, so the views stay valid for its whole lifetime, also after the arena is moved.
+A string longer than a block gets a block of its own.
+
+StringPool and FlatStringMap keep their strings here.
+*/
+class StringArena
+{
+public:
+  StringArena() = default;
+
+  // A moved-from arena is empty, and the next store() starts a new block
+  StringArena(StringArena&& other) noexcept
+    : m_blocks{ std::move(other.m_blocks) }, m_used{ std::exchange(other.m_used, blockSize) },
+      m_characters{ std::exchange(other.m_characters, 0) }
+  {}
+
+  StringArena& operator=(StringArena&& other) noexcept
+  {
+    if (&other == this) return *this;
+    m_blocks = std::exchange(other.m_blocks, {});
+    m_used = std::exchange(other.m_used, blockSize);
+    m_characters = std::exchange(other.m_characters, 0);
+    return *this;
+  }
+
+  std::string_view store(std::string_view string)
+  {
+    if (string.empty()) return {};
+    m_characters += string.size();
+    if (string.size() > blockSize) {
+      // inserted before the current block, so that one keeps being filled
+      auto position{ m_blocks.end() - (m_blocks.empty() ? 0 : 1) };
+      auto& block{ *m_blocks.insert(position, std::make_unique_for_overwrite<char[]>(string.size())) };
+      std::memcpy(block.get(), string.data(), string.size());
+      return { block.get(), string.size() };
+    }
+    if (blockSize - m_used < string.size()) {
+      m_blocks.push_back(std::make_unique_for_overwrite<char[]>(blockSize));
+      m_used = 0;
+    }
+    char* destination{ m_blocks.back().get() + m_used };
+    std::memcpy(destination, string.data(), string.size());
+    m_used += string.size();
+    return { destination, string.size() };
+  }
+
+  // Bytes of characters stored
+  std::size_t characters() const { return m_characters; }
+
+private:
+  static constexpr std::size_t blockSize{ 64 * 1024 };
+
+  std::vector<std::unique_ptr<char[]>> m_blocks{};
+  std::size_t m_used{ blockSize }; // in the last block, a full one until the first store()
+  std::size_t m_characters{ 0 };
+};
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include "StringArena.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional> // for std::hash
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Id of a string interned in a StringPool. Two symbols from the same pool are equal exactly when their strings are, so
+// comparing and hashing them is O(1) no matter how long the strings are. Symbol{} is the empty string.
+struct Symbol
+{
+  std::uint32_t id{};
+
+  friend bool operator==(Symbol, Symbol) = default;
+};
+
+template<> struct std::hash<Symbol>
+{
+  std::size_t operator()(Symbol s) const noexcept { return s.id; }
+};
+
+/*
+Stores every distinct string once. intern() returns the same Symbol every time it's given equal strings, and view()
+turns a Symbol back into a std::string_view.
+
+The characters are copied into a StringArena, whose blocks are never moved or freed before the pool, so the views stay
+valid for its whole lifetime (unlike views into a std::vector<std::string>, which reallocates). A million objects
+that share a handful of names then hold a 4-byte id each instead of a std::string with its own heap buffer.
+
+The index is an open-addressing hash table of ids with linear probing. The hash of every string is kept next to it, so a
+lookup only compares characters when the full hashes match, and growing the table doesn't hash anything again.
+
+Symbols only make sense for the pool that created them. The pool isn't thread-safe.
+*/
+class StringPool
+{
+public:
+  StringPool() { intern(""); }
+
+  // A moved-from pool is left like a new one, holding only the empty string. That allocates, so moving isn't noexcept.
+  StringPool(StringPool&& other) : StringPool() { swap(*this, other); }
+
+  StringPool& operator=(StringPool&& other)
+  {
+    StringPool taken{ std::move(other) };
+    swap(*this, taken);
+    return *this;
+  }
+
+  friend void swap(StringPool& a, StringPool& b) noexcept
+  {
+    std::swap(a.m_table, b.m_table);
+    std::swap(a.m_strings, b.m_strings);
+    std::swap(a.m_hashes, b.m_hashes);
+    std::swap(a.m_arena, b.m_arena);
+  }
+
+  // Copies the string into the pool the first time it's seen
+  Symbol intern(std::string_view string)
+  {
+    std::size_t hash{ std::hash<std::string_view>{}(string) };
+    std::size_t slot{ findSlot(string, hash) };
+    if (m_table[slot] != emptySlot) return Symbol{ m_table[slot] };
+
+    assert(m_strings.size() < emptySlot && "StringPool::intern(): too many strings");
+    auto id{ static_cast<std::uint32_t>(m_strings.size()) };
+    m_strings.push_back(m_arena.store(string));
+    m_hashes.push_back(hash);
+    m_table[slot] = id;
+    // keep the table at most half full, so probe sequences stay short
+    if (m_strings.size() * 2 > m_table.size()) grow();
+    return Symbol{ id };
+  }
+
+  // Looks the string up without adding it
+  std::optional<Symbol> find(std::string_view string) const
+  {
+    std::size_t slot{ findSlot(string, std::hash<std::string_view>{}(string)) };
+    if (m_table[slot] == emptySlot) return std::nullopt;
+    return Symbol{ m_table[slot] };
+  }
+
+  std::string_view view(Symbol symbol) const
+  {
+    assert(symbol.id < m_strings.size() && "StringPool::view(): symbol from another pool");
+    return m_strings[symbol.id];
+  }
+
+  // Number of distinct strings, including the empty one
+  std::size_t size() const { return m_strings.size(); }
+
+  // Bytes of characters stored in the arena
+  std::size_t characters() const { return m_arena.characters(); }
+
+private:
+  static constexpr std::uint32_t emptySlot{ std::numeric_limits<std::uint32_t>::max() };
+
+  std::vector<std::uint32_t> m_table = std::vector<std::uint32_t>(16, emptySlot);
+  std::vector<std::string_view> m_strings{}; // indexed by id
+  std::vector<std::size_t> m_hashes{}; // indexed by id
+  StringArena m_arena{};
+
+  // Slot that holds the string's id, or the empty slot where it would go
+  std::size_t findSlot(std::string_view string, std::size_t hash) const
+  {
+    std::size_t slot{ hash & (m_table.size() - 1) };
+    for (; m_table[slot] != emptySlot; slot = (slot + 1) & (m_table.size() - 1)) {
+      std::uint32_t id{ m_table[slot] };
+      if (m_hashes[id] == hash && m_strings[id] == string) break;
+    }
+    return slot;
+  }
+
+  void grow()
+  {
+    m_table.assign(m_table.size() * 2, emptySlot);
+    for (std::uint32_t id{ 0 }; id < m_strings.size(); ++id) {
+      std::size_t slot{ m_hashes[id] & (m_table.size() - 1) };
+      while (m_table[slot] != emptySlot) slot = (slot + 1) & (m_table.size() - 1);
+      m_table[slot] = id;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef FIZZ_BUZZ_H
+#define FIZZ_BUZZ_H
+
+#include "OutputBuffer.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <numeric> // for std::lcm
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+The fizzbuzz of 8.10_3 and 16.6_6 as a generator of output: line i is the words of all the divisors of i, in order, or
+i itself if there are none.
+
+Which lines are words and which are numbers repeats every lcm(divisors) lines (105 for 3, 5 and 7), so the whole
+period is laid out once in the constructor: the text of the lines that are words, and the positions of the numbers in
+between. Writing a period is then a copy of each run of word lines and one number per remaining line, formatted straight
+into an OutputBuffer, without a single division by a divisor.
+*/
+class FizzBuzz
+{
+public:
+  static constexpr std::uint64_t maxPeriod{ 1 << 24 };
+
+  FizzBuzz(std::span<const int> divisors, std::span<const std::string_view> words)
+    : m_divisors(divisors.begin(), divisors.end()), m_words(words.begin(), words.end())
+  {
+    assert(divisors.size() == words.size() && "FizzBuzz(): array sizes don't match");
+    for (int divisor : divisors) {
+      assert(divisor > 0 && "FizzBuzz(): divisors must be positive");
+      m_period = std::lcm(m_period, static_cast<std::uint64_t>(divisor));
+      if (m_period > maxPeriod) throw std::overflow_error{ "FizzBuzz(): the divisors repeat too rarely" };
+    }
+
+    for (std::uint64_t k{ 1 }; k <= m_period; ++k) {
+      std::size_t before{ m_text.size() };
+      appendWords(m_text, k);
+      if (m_text.size() == before) {
+        m_numbers.push_back({ m_text.size(), static_cast<std::uint32_t>(k) });
+      } else {
+        m_text += '\n';
+      }
+    }
+  }
+
+  // Lines 1 to n
+  void write(OutputBuffer& out, std::uint64_t n) const
+  {
+    std::uint64_t base{ 0 };
+    for (; n - base >= m_period; base += m_period) writePeriod(out, base);
+    for (std::uint64_t i{ base + 1 }; i <= n; ++i) writeLine(out, i);
+  }
+
+  std::uint64_t period() const { return m_period; }
+
+private:
+  struct NumberLine
+  {
+    std::size_t textEnd{}; // the word lines before this one end here in m_text
+    std::uint32_t offset{}; // line base + offset of every period
+  };
+
+  std::vector<int> m_divisors{};
+  std::vector<std::string> m_words{};
+  std::uint64_t m_period{ 1 };
+  std::string m_text{}; // the word lines of one period, with their '\n'
+  std::vector<NumberLine> m_numbers{};
+
+  void appendWords(std::string& line, std::uint64_t i) const
+  {
+    for (std::size_t j{ 0 }; j < m_divisors.size(); ++j) {
+      if (i % static_cast<std::uint64_t>(m_divisors[j]) == 0) line += m_words[j];
+    }
+  }
+
+  // Lines base + 1 to base + period
+  void writePeriod(OutputBuffer& out, std::uint64_t base) const
+  {
+    std::string_view text{ m_text };
+    std::size_t textBegin{ 0 };
+    for (const auto& number : m_numbers) {
+      out.write(text.substr(textBegin, number.textEnd - textBegin));
+      textBegin = number.textEnd;
+      char* position{ out.reserve(OutputBuffer::maxNumberLength + 1) };
+      position = OutputBuffer::formatNumber(position, base + number.offset);
+      *position++ = '\n';
+      out.commit(position);
+    }
+    out.write(text.substr(textBegin));
+  }
+
+  void writeLine(OutputBuffer& out, std::uint64_t i) const
+  {
+    std::string line{};
+    appendWords(line, i);
+    if (line.empty()) {
+      out.writeNumber(i);
+    } else {
+      out.write(line);
+    }
+    out.put('\n');
+  }
+};
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef LINE_FILE_H
+#define LINE_FILE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring> // for std::memchr, std::memcpy, std::strerror
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <fcntl.h> // for open
+#include <sys/mman.h> // for mmap, munmap, madvise
+#include <sys/stat.h> // for fstat, S_ISREG
+#include <unistd.h> // for read, write, close
+
+/*
+Whole-file line I/O for POSIX systems, for programs that process millions of short lines (names, ids, log records).
+
+Reading a line at a time with std::getline into std::strings costs an iostream call and usually a heap allocation per
+line. Here the file is mapped into memory (or read until its end if it can't be mapped, like a pipe), and the lines are
+std::string_views into that one buffer: no copies and no allocations per line. The views stay valid as long as the
+MappedFile does.
+
+writeLines() copies all the lines into one buffer and hands it to the kernel with a single write() (a few, if the
+kernel writes less than asked).
+
+Errors throw std::runtime_error with the file name and the system's message.
+*/
+namespace LineFile {
+  namespace detail {
+    [[noreturn]] inline void fail(const char* what, const std::string& path)
+    {
+      throw std::runtime_error{ std::string{ what } + " " + path + ": " + std::strerror(errno) };
+    }
+
+    class FileDescriptor
+    {
+    public:
+      explicit FileDescriptor(int fd) : m_fd{ fd } {}
+      FileDescriptor(const FileDescriptor&) = delete;
+      FileDescriptor& operator=(const FileDescriptor&) = delete;
+      ~FileDescriptor()
+      {
+        if (m_fd >= 0) ::close(m_fd);
+      }
+
+      int get() const { return m_fd; }
+
+    private:
+      int m_fd{ -1 };
+    };
+  } // namespace detail
+
+  class MappedFile
+  {
+  public:
+    explicit MappedFile(const std::string& path)
+    {
+      detail::FileDescriptor fd{ ::open(path.c_str(), O_RDONLY) };
+      if (fd.get() < 0) detail::fail("Can't open", path);
+      struct stat status{};
+      if (::fstat(fd.get(), &status) < 0) detail::fail("Can't stat", path);
+
+      // Only regular files can be mapped. Pipes, FIFOs and terminals report a size of 0 (so do some files in /proc),
+      // their contents are only known once they've been read.
+      if (S_ISREG(status.st_mode) && status.st_size > 0) {
+        m_size = static_cast<std::size_t>(status.st_size);
+        void* mapping{ ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd.get(), 0) };
+        if (mapping != MAP_FAILED) {
+          ::madvise(mapping, m_size, MADV_SEQUENTIAL); // a hint only, failing is fine
+          m_mapping = static_cast<const char*>(mapping);
+          return;
+        }
+      }
+      readAll(fd.get(), path);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+      if (m_mapping) ::munmap(const_cast<char*>(m_mapping), m_size);
+    }
+
+    std::string_view contents() const { return { m_mapping ? m_mapping : m_buffer.get(), m_size }; }
+
+  private:
+    const char* m_mapping{ nullptr };
+    std::unique_ptr<char[]> m_buffer{};
+    std::size_t m_size{ 0 };
+
+    // Reads until the end of the input into m_buffer, doubling it when it's full. m_size is the size of a regular file
+    // that couldn't be mapped, 0 for anything else.
+    void readAll(int fd, const std::string& path)
+    {
+      std::size_t capacity{ m_size > 0 ? m_size + 1 : 64 * 1024 }; // + 1 so a regular file ends with a read of 0
+      m_buffer = std::make_unique_for_overwrite<char[]>(capacity);
+      std::size_t done{ 0 };
+      while (true) {
+        if (done == capacity) {
+          auto larger{ std::make_unique_for_overwrite<char[]>(2 * capacity) };
+          std::memcpy(larger.get(), m_buffer.get(), done);
+          m_buffer = std::move(larger);
+          capacity *= 2;
+        }
+        ssize_t count{ ::read(fd, m_buffer.get() + done, capacity - done) };
+        if (count < 0 && errno == EINTR) continue;
+        if (count < 0) detail::fail("Can't read", path);
+        if (count == 0) break;
+        done += static_cast<std::size_t>(count);
+      }
+      m_size = done;
+    }
+  };
+
+  // Views of the lines of text without their line endings ("\n" or "\r\n"). A final line without '\n' is included, the
+  // empty line after a final '\n' isn't.
+  inline std::vector<std::string_view> splitLines(std::string_view text)
+  {
+    std::vector<std::string_view> lines{};
+    lines.reserve(text.size() / 16); // a guess, saves most of the reallocations for short lines
+    const char* position{ text.data() };
+    const char* end{ text.data() + text.size() };
+    while (position < end) {
+      std::size_t remaining{ static_cast<std::size_t>(end - position) };
+      const auto* newline{ static_cast<const char*>(std::memchr(position, '\n', remaining)) };
+      const char* lineEnd{ newline ? newline : end };
+      std::size_t length{ static_cast<std::size_t>(lineEnd - position) };
+      if (length > 0 && position[length - 1] == '\r') --length;
+      lines.emplace_back(position, length);
+      position = lineEnd + 1;
+    }
+    return lines;
+  }
+
+  // Writes every line followed by '\n', replacing the file
+  inline void writeLines(const std::string& path, std::span<const std::string_view> lines)
+  {
+    std::size_t size{ 0 };
+    for (auto line : lines) size += line.size() + 1;
+    auto buffer{ std::make_unique_for_overwrite<char[]>(size) };
+    char* out{ buffer.get() };
+    for (auto line : lines) {
+      std::memcpy(out, line.data(), line.size());
+      out += line.size();
+      *out++ = '\n';
+    }
+
+    detail::FileDescriptor fd{ ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+    if (fd.get() < 0) detail::fail("Can't create", path);
+    std::size_t done{ 0 };
+    while (done < size) {
+      ssize_t count{ ::write(fd.get(), buffer.get() + done, size - done) };
+      if (count < 0 && errno == EINTR) continue;
+      if (count < 0) detail::fail("Can't write", path);
+      done += static_cast<std::size_t>(count);
+    }
+  }
+} // namespace LineFile
+
+#endif
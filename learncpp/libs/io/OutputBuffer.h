@@ -0,0 +1,238 @@
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include <array>
+#include <bit> // for std::bit_width
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // for std::memcpy, std::strerror
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <fcntl.h> // for fcntl, vmsplice
+#include <sys/stat.h> // for fstat
+#include <sys/uio.h> // for iovec
+#include <unistd.h> // for write
+
+/*
+Buffered output to a file descriptor for programs that print millions of short lines, like fizzbuzz with a huge n.
+
+std::cout << does a virtual call, a sentry and a locale lookup per item, which is most of the time when the items are
+"fizz" or a small number. Here text is copied into a large buffer that's handed to the kernel when it's full, and
+numbers are formatted two digits at a time from a table of "00" to "99", right into the buffer.
+
+If the file descriptor is a pipe whose size can be set to the buffer's, the buffer is flushed with vmsplice(): the pipe
+refers to the buffer's pages instead of copying them. The pages must then stay untouched until the reader has consumed
+them, so there are two full buffers that take turns. Splicing one only returns once all of it is in the pipe, and a pipe
+the size of one buffer can't hold that while any of the other buffer is still in it: by the time a buffer is reused,
+nothing refers to it anymore. Partly filled buffers (an explicit flush(), the last one) are copied with write() instead,
+and so is everything that isn't such a pipe (files, terminals, /dev/null).
+
+For that, every buffer is filled exactly to its capacity before it's handed over: write() splits text at the end of the
+buffer and carries the rest over to the next one. Numbers and reserve() are formatted in place, so the buffers have
+maxReserve characters of overflow space past their capacity. Whatever lands there is moved to the start of the next
+buffer, and only the first capacity characters are flushed.
+
+Errors throw std::runtime_error. The destructor flushes what's left but can't report errors, call flush() first to see
+them.
+*/
+class OutputBuffer
+{
+public:
+  static constexpr std::size_t defaultCapacity{ 1 << 20 }; // the largest pipe an unprivileged process can ask for
+
+  static constexpr std::size_t maxNumberLength{ 20 }; // digits of 2^64 - 1
+  static constexpr std::size_t maxReserve{ 64 }; // the most reserve() can be asked for
+
+  explicit OutputBuffer(int fd, std::size_t capacity = defaultCapacity)
+    : m_fd{ fd }, m_capacity{ capacity },
+      m_buffers{ std::make_unique_for_overwrite<char[]>(capacity + maxReserve), nullptr }
+  {
+    assert(capacity > maxReserve && "OutputBuffer(): capacity too small");
+    struct stat status{};
+    if (::fstat(fd, &status) == 0 && S_ISFIFO(status.st_mode)
+        && ::fcntl(fd, F_SETPIPE_SZ, static_cast<int>(capacity)) == static_cast<int>(capacity)) {
+      m_buffers[1] = std::make_unique_for_overwrite<char[]>(capacity + maxReserve);
+    }
+    m_begin = m_position = m_buffers[0].get();
+    m_end = m_begin + capacity;
+  }
+
+  OutputBuffer(const OutputBuffer&) = delete;
+  OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+  ~OutputBuffer()
+  {
+    try {
+      flush();
+    } catch (const std::runtime_error&) {
+    }
+  }
+
+  void write(std::string_view text)
+  {
+    // fill the buffer up to its end and hand it over, so that it can be spliced
+    while (text.size() >= static_cast<std::size_t>(m_end - m_position)) {
+      auto part{ static_cast<std::size_t>(m_end - m_position) };
+      std::memcpy(m_position, text.data(), part);
+      m_position = m_end;
+      text.remove_prefix(part);
+      flushFull();
+    }
+    std::memcpy(m_position, text.data(), text.size());
+    m_position += text.size();
+  }
+
+  void put(char c)
+  {
+    *m_position++ = c;
+    if (m_position == m_end) flushFull();
+  }
+
+  void writeNumber(std::uint64_t number)
+  {
+    // there's always room for a number, past m_end if need be
+    m_position = formatNumber(m_position, number);
+    if (m_position >= m_end) flushFull();
+  }
+
+  // Room for size characters, to be written at the returned pointer and then committed
+  char* reserve([[maybe_unused]] std::size_t size)
+  {
+    assert(size <= maxReserve && "OutputBuffer::reserve(): more than maxReserve");
+    return m_position;
+  }
+
+  void commit(char* end)
+  {
+    assert(end >= m_position && end <= m_end + maxReserve && "OutputBuffer::commit(): not within the reserved space");
+    m_position = end;
+    if (m_position >= m_end) flushFull();
+  }
+
+  // Hands over everything written so far, a partly filled buffer is copied with write()
+  void flush()
+  {
+    if (m_position == m_begin) return;
+    writeAll(m_begin, static_cast<std::size_t>(m_position - m_begin));
+    m_position = m_begin;
+  }
+
+  // Total number of characters flushed so far
+  std::uint64_t written() const { return m_written; }
+
+  // Number of buffers handed to the pipe with vmsplice()
+  std::uint64_t splices() const { return m_splices; }
+
+  // Writes the decimal digits of number at out and returns the end
+  static char* formatNumber(char* out, std::uint64_t number)
+  {
+    std::size_t length{ digitCount(number) };
+    char* end{ out + length };
+    char* position{ end };
+    while (number >= 100) {
+      std::size_t pair{ static_cast<std::size_t>(number % 100) * 2 };
+      number /= 100;
+      *--position = digitPairs[pair + 1];
+      *--position = digitPairs[pair];
+    }
+    if (number >= 10) {
+      std::size_t pair{ static_cast<std::size_t>(number) * 2 };
+      *--position = digitPairs[pair + 1];
+      *--position = digitPairs[pair];
+    } else {
+      *--position = static_cast<char>('0' + number);
+    }
+    return end;
+  }
+
+private:
+  int m_fd{};
+  std::size_t m_capacity{};
+  std::array<std::unique_ptr<char[]>, 2> m_buffers{}; // the second one only when splicing into a pipe
+  std::size_t m_current{ 0 };
+  char* m_begin{ nullptr };
+  char* m_position{ nullptr };
+  char* m_end{ nullptr };
+  std::uint64_t m_written{ 0 };
+  std::uint64_t m_splices{ 0 };
+
+  static constexpr std::array<char, 200> digitPairs{ [] {
+    std::array<char, 200> pairs{};
+    for (std::size_t i{ 0 }; i < 100; ++i) {
+      pairs[2 * i] = static_cast<char>('0' + i / 10);
+      pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+    }
+    return pairs;
+  }() };
+
+  static constexpr std::array<std::uint64_t, maxNumberLength> powersOf10{ [] {
+    std::array<std::uint64_t, maxNumberLength> powers{};
+    powers[0] = 1;
+    for (std::size_t i{ 1 }; i < powers.size(); ++i) powers[i] = powers[i - 1] * 10;
+    return powers;
+  }() };
+
+  static std::size_t digitCount(std::uint64_t number)
+  {
+    number |= 1; // same digits, but 0 has a bit width of 1 like 1 does
+    // log10(2) is about 1233 / 4096, so this is the count minus one of the smallest number with the same bit width
+    auto estimate{ static_cast<std::size_t>(std::bit_width(number) * 1233) >> 12 };
+    return estimate + (number >= powersOf10[estimate]);
+  }
+
+  [[noreturn]] static void fail(const char* what)
+  {
+    throw std::runtime_error{ std::string{ what } + ": " + std::strerror(errno) };
+  }
+
+  // The buffer holds at least its capacity: those characters are handed over and the overflow is carried over
+  void flushFull()
+  {
+    char* overflow{ m_end };
+    auto overflowSize{ static_cast<std::size_t>(m_position - m_end) };
+    if (m_buffers[1]) {
+      splice(m_begin, m_capacity);
+      m_current ^= 1;
+      m_begin = m_buffers[m_current].get();
+      m_end = m_begin + m_capacity;
+    } else {
+      writeAll(m_begin, m_capacity);
+    }
+    // the overflow is shorter than maxReserve, which is less than the capacity, so the ranges can't overlap
+    std::memcpy(m_begin, overflow, overflowSize);
+    m_position = m_begin + overflowSize;
+  }
+
+  void writeAll(const char* data, std::size_t size)
+  {
+    std::size_t done{ 0 };
+    while (done < size) {
+      ssize_t count{ ::write(m_fd, data + done, size - done) };
+      if (count < 0 && errno == EINTR) continue;
+      if (count < 0) fail("Can't write output");
+      done += static_cast<std::size_t>(count);
+    }
+    m_written += size;
+  }
+
+  void splice(char* data, std::size_t size)
+  {
+    std::size_t done{ 0 };
+    while (done < size) {
+      iovec io{ data + done, size - done };
+      ssize_t count{ ::vmsplice(m_fd, &io, 1, 0) };
+      if (count < 0 && errno == EINTR) continue;
+      if (count < 0) fail("Can't splice output");
+      done += static_cast<std::size_t>(count);
+    }
+    m_written += size;
+    ++m_splices;
+  }
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef FAST_VISIT_H
+#define FAST_VISIT_H
+
+#include <cstddef>
+#include <functional> // for std::invoke
+#include <type_traits>
+#include <utility> // for std::forward, std::unreachable
+#include <variant>
+
+/*
+Poly::fastVisit(visitor, variant) is std::visit(visitor, variant) for a single variant, compiled to a switch on the
+index for variants of up to 16 alternatives.
+
+How std::visit dispatches is up to the library: through a table of function pointers, one per alternative, for all but
+small variants (libstdc++ switches up to 11). Every call is then an indirect call that the compiler can't inline, so the
+visitor's code is never optimized together with the loop around it. A switch becomes a jump table too, but the jumps
+land on inlined visitor code, and the compiler can merge cases that do the same thing.
+
+That only pays off while the inlined cases are small: ch25/dispatch.cpp measured a 32-case switch at 2.8 ns per event
+against 1.9 ns for std::visit when the events are grouped by type, and chaining smaller switches adds a second
+hard-to-predict jump. Variants of more than 16 alternatives go to std::visit.
+
+ch25/dispatch.cpp compares it with virtual functions, std::visit, a table of function pointers and type erasure.
+
+Like std::visit, it throws std::bad_variant_access for a variant that's valueless by exception, and the visitor must
+return the same type for every alternative.
+*/
+namespace Poly {
+  namespace detail {
+    constexpr std::size_t casesPerSwitch{ 16 };
+
+    template<typename Result, std::size_t I, typename Visitor, typename Variant>
+    constexpr Result visitAlternative(Visitor&& visitor, Variant&& variant)
+    {
+      if constexpr (I < std::variant_size_v<std::remove_cvref_t<Variant>>) {
+        // the switch has checked the index already, std::get would check it again
+        using Alternative = decltype(std::get<I>(std::forward<Variant>(variant)));
+        return std::invoke(std::forward<Visitor>(visitor), static_cast<Alternative>(*std::get_if<I>(&variant)));
+      } else {
+        std::unreachable();
+      }
+    }
+
+    // Up to casesPerSwitch alternatives
+    template<typename Result, typename Visitor, typename Variant>
+    constexpr Result visitWithSwitch(Visitor&& visitor, Variant&& variant)
+    {
+      switch (variant.index()) {
+      case 0:
+        return visitAlternative<Result, 0>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 1:
+        return visitAlternative<Result, 1>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 2:
+        return visitAlternative<Result, 2>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 3:
+        return visitAlternative<Result, 3>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 4:
+        return visitAlternative<Result, 4>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 5:
+        return visitAlternative<Result, 5>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 6:
+        return visitAlternative<Result, 6>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 7:
+        return visitAlternative<Result, 7>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 8:
+        return visitAlternative<Result, 8>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 9:
+        return visitAlternative<Result, 9>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 10:
+        return visitAlternative<Result, 10>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 11:
+        return visitAlternative<Result, 11>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 12:
+        return visitAlternative<Result, 12>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 13:
+        return visitAlternative<Result, 13>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 14:
+        return visitAlternative<Result, 14>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      case 15:
+        return visitAlternative<Result, 15>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+      default:
+        std::unreachable();
+      }
+    }
+  } // namespace detail
+
+  template<typename Visitor, typename Variant> constexpr decltype(auto) fastVisit(Visitor&& visitor, Variant&& variant)
+  {
+    if constexpr (std::variant_size_v<std::remove_cvref_t<Variant>> <= detail::casesPerSwitch) {
+      using Result = std::invoke_result_t<Visitor, decltype(std::get<0>(std::forward<Variant>(variant)))>;
+      if (variant.valueless_by_exception()) throw std::bad_variant_access{};
+      return detail::visitWithSwitch<Result>(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+    } else {
+      return std::visit(std::forward<Visitor>(visitor), std::forward<Variant>(variant));
+    }
+  }
+} // namespace Poly
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef POLY_COLLECTION_H
+#define POLY_COLLECTION_H
+
+#include <concepts> // for std::invocable
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+A collection of objects from a closed set of types, like std::vector<std::unique_ptr<Shape>> when every Shape is a
+Circle or a Triangle:
+  PolyCollection<Circle, Triangle> shapes{};
+  shapes.emplace<Circle>(Point{ 1, 2 }, 7);
+
+Every type has its own std::vector, so the objects are stored by value next to others of their type: no allocation per
+object, no pointer to follow to reach one, and a loop over one type runs over contiguous memory.
+- all<Circle>() is a span of just the circles. Finding them in a vector of pointers takes a dynamic_cast (a walk over
+  the type info) per object, here it takes nothing at all, and the compiler knows the type of every element.
+- forEach(visitor) calls visitor(object) for every object, one type after the other. It doesn't compile unless the
+  visitor accepts every type, so adding a type to the collection points out every visitor that doesn't handle it yet.
+
+Objects are visited by type, not in the order they were added.
+*/
+template<typename... Types>
+  requires(sizeof...(Types) > 0)
+class PolyCollection
+{
+public:
+  template<typename T>
+  static constexpr bool holds{ (std::is_same_v<T, Types> || ...) };
+
+  template<typename T, typename... Args>
+    requires holds<T>
+  T& emplace(Args&&... args)
+  {
+    return segment<T>().emplace_back(std::forward<Args>(args)...);
+  }
+
+  template<typename T>
+    requires holds<std::remove_cvref_t<T>>
+  std::remove_cvref_t<T>& insert(T&& object)
+  {
+    auto& objects{ segment<std::remove_cvref_t<T>>() };
+    objects.push_back(std::forward<T>(object));
+    return objects.back();
+  }
+
+  template<typename T>
+    requires holds<T>
+  std::span<T> all()
+  {
+    return segment<T>();
+  }
+
+  template<typename T>
+    requires holds<T>
+  std::span<const T> all() const
+  {
+    return segment<T>();
+  }
+
+  template<typename Visitor> void forEach(Visitor&& visitor)
+  {
+    static_assert(
+      (std::invocable<Visitor&, Types&> && ...), "PolyCollection::forEach(): the visitor must take every type");
+    (visitAll<Types>(visitor), ...);
+  }
+
+  template<typename Visitor> void forEach(Visitor&& visitor) const
+  {
+    static_assert(
+      (std::invocable<Visitor&, const Types&> && ...), "PolyCollection::forEach(): the visitor must take every type");
+    (visitAll<Types>(visitor), ...);
+  }
+
+  std::size_t size() const { return (segment<Types>().size() + ...); }
+  bool empty() const { return size() == 0; }
+
+  template<typename T>
+    requires holds<T>
+  std::size_t count() const
+  {
+    return segment<T>().size();
+  }
+
+  template<typename T>
+    requires holds<T>
+  void reserve(std::size_t capacity)
+  {
+    segment<T>().reserve(capacity);
+  }
+
+  void clear() { (segment<Types>().clear(), ...); }
+
+private:
+  std::tuple<std::vector<Types>...> m_segments{};
+
+  template<typename T> std::vector<T>& segment() { return std::get<std::vector<T>>(m_segments); }
+  template<typename T> const std::vector<T>& segment() const { return std::get<std::vector<T>>(m_segments); }
+
+  template<typename T, typename Visitor> void visitAll(Visitor& visitor)
+  {
+    for (T& object : segment<T>()) visitor(object);
+  }
+
+  template<typename T, typename Visitor> void visitAll(Visitor& visitor) const
+  {
+    for (const T& object : segment<T>()) visitor(object);
+  }
+};
+
+#endif
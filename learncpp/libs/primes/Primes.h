@@ -0,0 +1,310 @@
+#ifndef PRIMES_H
+#define PRIMES_H
+
+#include "../threads/ThreadPool.h"
+#include <algorithm> // for std::min, std::max, std::count
+#include <array>
+#include <bit> // for std::countr_zero, std::bit_width
+#include <cassert>
+#include <cmath> // for std::sqrt
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <span>
+#include <vector>
+
+/*
+Primality for 64-bit integers, replacing the trial division of isPrime() from 8.x_2 (which takes O(sqrt(n)) divisions
+per number and, with its i * i < x, calls squares of primes like 9 and 25 prime).
+
+- isPrime(n) rejects multiples of the primes up to 53 without dividing (n * p^-1 mod 2^64 is small exactly when p
+  divides n), then runs Miller-Rabin with a set of bases that's known to have no strong pseudoprimes below 2^64, so the
+  answer is exact. The modular products use Montgomery multiplication: two multiplications and no division each.
+- isPrime(values, results) classifies a whole batch, spread over the threads of a pool.
+- primesBetween(low, high) and countPrimes(low, high) run a segmented sieve of Eratosthenes over [low, high). Only odd
+  numbers are stored, a byte each, and the range is sieved in 32 KB segments that stay in the L1 cache while every
+  sieving prime crosses off its multiples. With a pool, the segments are split into chunks that are sieved in parallel.
+  The sieve takes O((high - low) log log high) steps plus O(sqrt(high)) for the sieving primes, far less per number
+  than Miller-Rabin when the range is dense.
+*/
+namespace Primes {
+  namespace detail {
+    __extension__ typedef unsigned __int128 UInt128; // __extension__ keeps -pedantic-errors quiet about the extension
+
+    // The inverse of an odd number modulo 2^64, by Newton's iteration (every step doubles the correct low bits)
+    constexpr std::uint64_t inverse(std::uint64_t odd)
+    {
+      std::uint64_t x{ odd }; // correct to 3 bits, since odd * odd = 1 mod 8
+      for (int i{ 0 }; i < 5; ++i) x *= 2 - odd * x;
+      return x;
+    }
+
+    // Arithmetic modulo an odd n on numbers in Montgomery form, a * 2^64 mod n
+    class Montgomery
+    {
+    public:
+      explicit Montgomery(std::uint64_t modulus)
+        : m_modulus{ modulus }, m_inverse{ inverse(modulus) }, m_one{ -modulus % modulus },
+          m_rSquared{ static_cast<std::uint64_t>(static_cast<UInt128>(m_one) * m_one % modulus) }
+      {
+        assert((modulus & 1) && "Primes::detail::Montgomery(): the modulus must be odd");
+      }
+
+      std::uint64_t toForm(std::uint64_t a) const { return multiply(a % m_modulus, m_rSquared); }
+      std::uint64_t one() const { return m_one; }
+      std::uint64_t minusOne() const { return m_modulus - m_one; }
+
+      // a * b * 2^-64 mod n, for a, b < n
+      std::uint64_t multiply(std::uint64_t a, std::uint64_t b) const
+      {
+        UInt128 product{ static_cast<UInt128>(a) * b };
+        // m * n has the same low 64 bits as the product, so subtracting it leaves a multiple of 2^64
+        std::uint64_t m{ static_cast<std::uint64_t>(product) * m_inverse };
+        auto high{ static_cast<std::uint64_t>(product >> 64) };
+        auto subtrahend{ static_cast<std::uint64_t>(static_cast<UInt128>(m) * m_modulus >> 64) };
+        return high >= subtrahend ? high - subtrahend : high - subtrahend + m_modulus;
+      }
+
+      std::uint64_t power(std::uint64_t base, std::uint64_t exponent) const
+      {
+        std::uint64_t result{ m_one };
+        for (int bit{ static_cast<int>(std::bit_width(exponent)) - 1 }; bit >= 0; --bit) {
+          result = multiply(result, result);
+          if ((exponent >> bit) & 1) result = multiply(result, base);
+        }
+        return result;
+      }
+
+    private:
+      std::uint64_t m_modulus{};
+      std::uint64_t m_inverse{};
+      std::uint64_t m_one{}; // 2^64 mod n
+      std::uint64_t m_rSquared{}; // 2^128 mod n, converts into Montgomery form
+    };
+
+    // Strong probable prime test of an odd n > 2 to the given base
+    inline bool isStrongProbablePrime(const Montgomery& mont, std::uint64_t n, std::uint64_t base)
+    {
+      std::uint64_t d{ n - 1 };
+      int s{ std::countr_zero(d) };
+      d >>= s;
+      std::uint64_t a{ base % n };
+      if (a == 0) return true;
+      std::uint64_t x{ mont.power(mont.toForm(a), d) };
+      if (x == mont.one() || x == mont.minusOne()) return true;
+      for (int i{ 1 }; i < s; ++i) {
+        x = mont.multiply(x, x);
+        if (x == mont.minusOne()) return true;
+      }
+      return false;
+    }
+
+    struct Divisor
+    {
+      std::uint32_t prime{};
+      std::uint64_t inverse{};
+      std::uint64_t limit{}; // n is a multiple of prime exactly when n * inverse <= limit (mod 2^64)
+    };
+
+    constexpr std::array<Divisor, 15> smallDivisors{ [] {
+      constexpr std::uint32_t primes[]{ 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53 };
+      std::array<Divisor, 15> divisors{};
+      for (std::size_t i{ 0 }; i < divisors.size(); ++i) {
+        divisors[i] = { primes[i], inverse(primes[i]), std::numeric_limits<std::uint64_t>::max() / primes[i] };
+      }
+      return divisors;
+    }() };
+
+    // Every composite below 59 * 59 has a prime factor of at most 53
+    constexpr std::uint64_t trialDivisionLimit{ 59 * 59 };
+
+    inline std::uint64_t isqrt(std::uint64_t n)
+    {
+      auto root{ static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n))) };
+      // the double may be off by one either way for large n
+      while (root > 0 && (root > std::numeric_limits<std::uint32_t>::max() || root * root > n)) --root;
+      while (root < std::numeric_limits<std::uint32_t>::max() && (root + 1) * (root + 1) <= n) ++root;
+      return root;
+    }
+  } // namespace detail
+
+  // Exact for every 64-bit n
+  inline bool isPrime(std::uint64_t n)
+  {
+    if (n < 2) return false;
+    if ((n & 1) == 0) return n == 2;
+    for (const auto& divisor : detail::smallDivisors) {
+      if (n * divisor.inverse <= divisor.limit) return n == divisor.prime;
+    }
+    if (n < detail::trialDivisionLimit) return true;
+
+    // bases with no strong pseudoprimes below the bound (Jaeschke for 2^32, Sinclair for 2^64)
+    constexpr std::uint64_t bases32[]{ 2, 7, 61 };
+    constexpr std::uint64_t bases64[]{ 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+    detail::Montgomery mont{ n };
+    std::span<const std::uint64_t> bases{ n >> 32 ? std::span<const std::uint64_t>{ bases64 } : bases32 };
+    for (std::uint64_t base : bases) {
+      if (!detail::isStrongProbablePrime(mont, n, base)) return false;
+    }
+    return true;
+  }
+
+  // results[i] = isPrime(values[i]), on the calling thread
+  inline void isPrime(std::span<const std::uint64_t> values, std::span<bool> results)
+  {
+    assert(values.size() == results.size() && "Primes::isPrime(): results must have one element per value");
+    for (std::size_t i{ 0 }; i < values.size(); ++i) results[i] = isPrime(values[i]);
+  }
+
+  // results[i] = isPrime(values[i]), split into one block per thread of the pool
+  inline void isPrime(std::span<const std::uint64_t> values, std::span<bool> results, ThreadPool& pool)
+  {
+    assert(values.size() == results.size() && "Primes::isPrime(): results must have one element per value");
+    // a block must take long enough to be worth handing to another thread
+    constexpr std::size_t minBlock{ 1 << 14 };
+    std::size_t blocks{ std::min<std::size_t>(pool.size(), (values.size() + minBlock - 1) / minBlock) };
+    if (blocks < 2) return isPrime(values, results);
+
+    std::vector<std::future<void>> done{};
+    for (std::size_t b{ 0 }; b < blocks; ++b) {
+      std::size_t first{ b * values.size() / blocks };
+      std::size_t count{ (b + 1) * values.size() / blocks - first };
+      done.push_back(pool.submit([=] { isPrime(values.subspan(first, count), results.subspan(first, count)); }));
+    }
+    for (auto& d : done) d.get();
+  }
+
+  namespace detail {
+    constexpr std::size_t segmentBytes{ 1 << 15 }; // one byte per odd number, the segment fills most of the L1 cache
+    constexpr std::uint64_t segmentSpan{ 2 * segmentBytes };
+
+    // The odd primes up to the square root of high - 1, which are enough to sieve [0, high)
+    inline std::vector<std::uint32_t> sievingPrimes(std::uint64_t high)
+    {
+      std::uint64_t limit{ high > 0 ? isqrt(high - 1) : 0 };
+      std::vector<bool> composite(limit + 1);
+      std::vector<std::uint32_t> primes{};
+      for (std::uint64_t p{ 3 }; p <= limit; p += 2) {
+        if (composite[p]) continue;
+        primes.push_back(static_cast<std::uint32_t>(p));
+        for (std::uint64_t multiple{ p * p }; multiple <= limit; multiple += 2 * p) composite[multiple] = true;
+      }
+      return primes;
+    }
+
+    /*
+    Sieves [low, high) segment by segment and calls visit(first, composite) for each, where composite[i] tells whether
+    the odd number first + 2i is composite (or 1). 2 isn't in any segment.
+    */
+    template<typename Visit>
+    void sieve(std::uint64_t low, std::uint64_t high, std::span<const std::uint32_t> primes, Visit visit)
+    {
+      std::vector<std::uint8_t> composite(segmentBytes);
+      for (std::uint64_t segmentLow{ low }; segmentLow < high;) {
+        std::uint64_t segmentHigh{ std::min(high, segmentLow + segmentSpan) };
+        std::uint64_t first{ segmentLow | 1 };
+        segmentLow = segmentHigh;
+        if (first >= segmentHigh) continue;
+        std::size_t count{ static_cast<std::size_t>((segmentHigh - first + 1) / 2) };
+        std::fill_n(composite.begin(), count, std::uint8_t{ 0 });
+        if (first == 1) composite[0] = 1;
+
+        for (std::uint32_t p : primes) {
+          std::uint64_t square{ std::uint64_t{ p } * p };
+          if (square >= segmentHigh) break;
+          // the first odd multiple of p in the segment, but not p itself
+          std::uint64_t multiple{ std::max(square, (first + p - 1) / p * p) };
+          if ((multiple & 1) == 0) multiple += p;
+          for (auto i{ static_cast<std::size_t>((multiple - first) / 2) }; i < count; i += p) composite[i] = 1;
+        }
+        visit(first, std::span<const std::uint8_t>{ composite.data(), count });
+      }
+    }
+
+    inline void primesInRange(std::uint64_t low, std::uint64_t high, std::span<const std::uint32_t> sievingPrimes,
+                              std::vector<std::uint64_t>& primes)
+    {
+      if (low <= 2 && high > 2) primes.push_back(2);
+      sieve(low, high, sievingPrimes, [&](std::uint64_t first, std::span<const std::uint8_t> composite) {
+        for (std::size_t i{ 0 }; i < composite.size(); ++i) {
+          if (!composite[i]) primes.push_back(first + 2 * i);
+        }
+      });
+    }
+
+    inline std::uint64_t countInRange(std::uint64_t low, std::uint64_t high, std::span<const std::uint32_t> primes)
+    {
+      std::uint64_t count{ (low <= 2 && high > 2) ? 1u : 0u };
+      sieve(low, high, primes, [&](std::uint64_t, std::span<const std::uint8_t> composite) {
+        count += static_cast<std::uint64_t>(std::count(composite.begin(), composite.end(), std::uint8_t{ 0 }));
+      });
+      return count;
+    }
+
+    // Splits [low, high) into chunks of whole segments, a few per thread so an uneven split doesn't hold up the rest,
+    // and returns sieveChunk(chunkLow, chunkHigh) of each in order
+    template<typename SieveChunk>
+    auto sieveChunks(std::uint64_t low, std::uint64_t high, ThreadPool& pool, SieveChunk sieveChunk)
+    {
+      using Result = decltype(sieveChunk(low, high));
+      std::uint64_t segments{ (high - low + segmentSpan - 1) / segmentSpan };
+      std::uint64_t chunks{ std::min<std::uint64_t>(segments, std::uint64_t{ pool.size() } * 4) };
+      std::vector<std::future<Result>> futures{};
+      for (std::uint64_t c{ 0 }; c < chunks; ++c) {
+        std::uint64_t chunkLow{ low + c * segments / chunks * segmentSpan };
+        std::uint64_t chunkHigh{ std::min(high, low + (c + 1) * segments / chunks * segmentSpan) };
+        futures.push_back(pool.submit([=, &sieveChunk] { return sieveChunk(chunkLow, chunkHigh); }));
+      }
+      std::vector<Result> results{};
+      for (auto& f : futures) results.push_back(f.get());
+      return results;
+    }
+  } // namespace detail
+
+  // The primes in [low, high), in ascending order
+  inline std::vector<std::uint64_t> primesBetween(std::uint64_t low, std::uint64_t high)
+  {
+    std::vector<std::uint64_t> primes{};
+    if (low < high) detail::primesInRange(low, high, detail::sievingPrimes(high), primes);
+    return primes;
+  }
+
+  inline std::vector<std::uint64_t> primesBetween(std::uint64_t low, std::uint64_t high, ThreadPool& pool)
+  {
+    if (low >= high) return {};
+    std::vector<std::uint32_t> sievingPrimes{ detail::sievingPrimes(high) };
+    auto chunks{ detail::sieveChunks(low, high, pool, [&](std::uint64_t first, std::uint64_t last) {
+      std::vector<std::uint64_t> primes{};
+      detail::primesInRange(first, last, sievingPrimes, primes);
+      return primes;
+    }) };
+    std::size_t count{ 0 };
+    for (const auto& chunk : chunks) count += chunk.size();
+    std::vector<std::uint64_t> primes{};
+    primes.reserve(count);
+    for (const auto& chunk : chunks) primes.insert(primes.end(), chunk.begin(), chunk.end());
+    return primes;
+  }
+
+  // The number of primes in [low, high), without storing them
+  inline std::uint64_t countPrimes(std::uint64_t low, std::uint64_t high)
+  {
+    return low < high ? detail::countInRange(low, high, detail::sievingPrimes(high)) : 0;
+  }
+
+  inline std::uint64_t countPrimes(std::uint64_t low, std::uint64_t high, ThreadPool& pool)
+  {
+    if (low >= high) return 0;
+    std::vector<std::uint32_t> sievingPrimes{ detail::sievingPrimes(high) };
+    std::uint64_t count{ 0 };
+    for (std::uint64_t c : detail::sieveChunks(low, high, pool, [&](std::uint64_t first, std::uint64_t last) {
+           return detail::countInRange(first, last, sievingPrimes);
+         })) {
+      count += c;
+    }
+    return count;
+  }
+} // namespace Primes
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef LINEAR_SYSTEM_H
+#define LINEAR_SYSTEM_H
+
+#include "Rational.h"
+#include <algorithm> // for std::min
+#include <atomic>
+#include <barrier>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric> // for std::gcd
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+Exact solver for dense linear systems A * x = b over Rational<std::int64_t>, using fraction-free (Bareiss) Gaussian
+elimination.
+
+Every row is first scaled by the lcm of its denominators, so the elimination runs on integers only:
+  m[i][j] = (m[k][k] * m[i][j] - m[i][k] * m[k][j]) / m[k-1][k-1]
+The division is always exact (every entry after step k is a (k+1)x(k+1) minor of the matrix), so no gcd is ever needed
+and the entries grow only linearly in bits, not exponentially as with plain integer elimination. Back substitution is
+fraction-free as well and produces the Cramer numerators, so the only Rational that is built per unknown is the result
+y[i] / det.
+
+Products are computed in 128 bits. Entries are stored in 64 bits, so if a minor of the matrix doesn't fit into
+std::int64_t, solve() throws std::overflow_error. Arbitrarily large dense systems need a big integer type, which is out
+of scope here.
+
+Execution::parallel splits the rows of every elimination step between worker threads. The threads live for the whole
+elimination and meet at a std::barrier after each step; the pivot for the next step is chosen in the barrier's
+completion function, while the other threads wait.
+*/
+namespace LinearSystem {
+  using Value = Rational<std::int64_t>;
+  using Matrix = std::vector<std::vector<Value>>;
+
+  enum class Execution {
+    sequential,
+    parallel,
+  };
+
+  namespace detail {
+    __extension__ typedef __int128 Int128;
+
+    inline std::int64_t narrow(Int128 value)
+    {
+      if (value < std::numeric_limits<std::int64_t>::min() || value > std::numeric_limits<std::int64_t>::max()) {
+        throw std::overflow_error("LinearSystem: entry doesn't fit into 64 bits");
+      }
+      return static_cast<std::int64_t>(value);
+    }
+
+    // sum - a * b, where the product of two 64-bit values always fits but a sum of many of them may not
+    inline Int128 subtractProduct(Int128 sum, std::int64_t a, std::int64_t b)
+    {
+      Int128 product{};
+      if (__builtin_mul_overflow(Int128{ a }, Int128{ b }, &product) || __builtin_sub_overflow(sum, product, &sum)) {
+        throw std::overflow_error("LinearSystem: back substitution doesn't fit into 128 bits");
+      }
+      return sum;
+    }
+
+    // Row-major n x (n + 1) augmented integer matrix
+    class IntegerMatrix
+    {
+    public:
+      IntegerMatrix(const Matrix& a, const std::vector<Value>& b) : m_size{ b.size() }, m_data(m_size * (m_size + 1))
+      {
+        for (std::size_t i{ 0 }; i < m_size; ++i) {
+          assert(a[i].size() == m_size && "LinearSystem::solve(): matrix must be square");
+          // scale the row by the lcm of its denominators, so all entries become integers
+          std::int64_t scale{ b[i].normalized().denominator() };
+          for (const auto& v : a[i]) {
+            std::int64_t d{ v.normalized().denominator() };
+            scale = narrow(Int128{ scale / std::gcd(scale, d) } * d);
+          }
+          for (std::size_t j{ 0 }; j < m_size; ++j) (*this)(i, j) = toInteger(a[i][j], scale);
+          (*this)(i, m_size) = toInteger(b[i], scale);
+        }
+      }
+
+      std::int64_t& operator()(std::size_t row, std::size_t column) { return m_data[row * (m_size + 1) + column]; }
+      std::size_t size() const { return m_size; }
+
+      void swapRows(std::size_t r1, std::size_t r2)
+      {
+        for (std::size_t j{ 0 }; j <= m_size; ++j) std::swap((*this)(r1, j), (*this)(r2, j));
+      }
+
+      // Finds a row with a non-zero entry in column k (starting with row k) and moves it to row k
+      bool pivot(std::size_t k)
+      {
+        for (std::size_t p{ k }; p < m_size; ++p) {
+          if ((*this)(p, k) != 0) {
+            if (p != k) swapRows(p, k);
+            return true;
+          }
+        }
+        return false;
+      }
+
+      // One Bareiss step for rows first, first + stride, ... below the pivot row k
+      void eliminate(std::size_t k, std::int64_t previousPivot, std::size_t first, std::size_t stride)
+      {
+        const std::int64_t pivot{ (*this)(k, k) };
+        for (std::size_t i{ first }; i < m_size; i += stride) {
+          const std::int64_t factor{ (*this)(i, k) };
+          for (std::size_t j{ k + 1 }; j <= m_size; ++j) {
+            Int128 value{ Int128{ pivot } * (*this)(i, j) - Int128{ factor } * (*this)(k, j) };
+            (*this)(i, j) = narrow(value / previousPivot); // exact division
+          }
+          (*this)(i, k) = 0;
+        }
+      }
+
+    private:
+      static std::int64_t toInteger(const Value& v, std::int64_t scale)
+      {
+        Value reduced{ v.normalized() };
+        return narrow(Int128{ reduced.numerator() } * (scale / reduced.denominator()));
+      }
+
+      std::size_t m_size{};
+      std::vector<std::int64_t> m_data{};
+    };
+
+    inline void eliminateSequential(IntegerMatrix& m, bool& singular)
+    {
+      std::int64_t previousPivot{ 1 };
+      for (std::size_t k{ 0 }; k < m.size(); ++k) {
+        if (!m.pivot(k)) {
+          singular = true;
+          return;
+        }
+        m.eliminate(k, previousPivot, k + 1, 1);
+        previousPivot = m(k, k);
+      }
+    }
+
+    inline void eliminateParallel(IntegerMatrix& m, bool& singular, unsigned threadCount)
+    {
+      const std::size_t n{ m.size() };
+      std::size_t k{ 0 };
+      std::int64_t previousPivot{ 1 };
+      bool done{ !m.pivot(0) };
+      singular = done;
+
+      std::atomic<bool> failed{ false };
+      std::exception_ptr error{};
+      std::mutex errorMutex{};
+
+      // runs once per step on one thread, after all rows of step k are eliminated and before any thread continues
+      auto nextStep{ [&]() noexcept {
+        if (failed) {
+          done = true;
+          return;
+        }
+        previousPivot = m(k, k);
+        ++k;
+        if (k >= n) {
+          done = true;
+        } else if (!m.pivot(k)) {
+          singular = true;
+          done = true;
+        }
+      } };
+      std::barrier sync{ static_cast<std::ptrdiff_t>(threadCount), nextStep };
+
+      auto worker{ [&](unsigned index) {
+        while (!done) {
+          // rows are interleaved between threads, so the shrinking trailing matrix stays balanced
+          if (!failed) {
+            try {
+              m.eliminate(k, previousPivot, k + 1 + index, threadCount);
+            } catch (...) {
+              std::lock_guard lock{ errorMutex };
+              if (!error) error = std::current_exception();
+              failed = true;
+            }
+          }
+          sync.arrive_and_wait();
+        }
+      } };
+
+      if (!done) {
+        std::vector<std::jthread> threads{};
+        for (unsigned t{ 1 }; t < threadCount; ++t) threads.emplace_back(worker, t);
+        worker(0);
+      } // jthreads join here
+
+      if (error) std::rethrow_exception(error);
+    }
+  } // namespace detail
+
+  // Returns std::nullopt if the matrix is singular.
+  // Throws std::overflow_error if an intermediate minor doesn't fit into 64 bits.
+  inline std::optional<std::vector<Value>> solve(
+    const Matrix& a, const std::vector<Value>& b, Execution execution = Execution::sequential, unsigned threadCount = 0)
+  {
+    assert(a.size() == b.size() && "LinearSystem::solve(): matrix and vector sizes differ");
+    const std::size_t n{ b.size() };
+    if (n == 0) return std::vector<Value>{};
+
+    detail::IntegerMatrix m{ a, b };
+    bool singular{ false };
+    if (execution == Execution::parallel) {
+      if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+      threadCount = static_cast<unsigned>(std::min<std::size_t>(threadCount, n));
+      detail::eliminateParallel(m, singular, threadCount);
+    } else {
+      detail::eliminateSequential(m, singular);
+    }
+    if (singular) return std::nullopt;
+
+    // Fraction-free back substitution: x[i] = y[i] / det, where y[i] are integers (Cramer's rule numerators)
+    const std::int64_t det{ m(n - 1, n - 1) };
+    std::vector<std::int64_t> y(n);
+    for (std::size_t i{ n }; i-- > 0;) {
+      detail::Int128 sum{ detail::Int128{ det } * m(i, n) };
+      for (std::size_t j{ i + 1 }; j < n; ++j) sum = detail::subtractProduct(sum, m(i, j), y[j]);
+      y[i] = detail::narrow(sum / m(i, i));
+    }
+
+    std::vector<Value> x{};
+    x.reserve(n);
+    for (std::size_t i{ 0 }; i < n; ++i) x.emplace_back(y[i], det);
+    return x;
+  }
+} // namespace LinearSystem
+
+#endif
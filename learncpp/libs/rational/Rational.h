@@ -0,0 +1,320 @@
+#ifndef RATIONAL_H
+#define RATIONAL_H
+
+#include <bit> // for std::countr_zero
+#include <cassert>
+#include <cmath> // for std::floor, std::isfinite
+#include <compare> // for std::strong_ordering
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/*
+Header-only exact fraction type that replaces the int Fraction classes from the quizzes (13.10, 21.2, 21.4, 21.7, ...).
+Those classes call std::gcd in reduce() on every construction and silently overflow in operator*.
+
+Rational<T> differs in a few ways:
+- overflow throws std::overflow_error instead of producing garbage. Reduced products are computed in T with
+  __builtin_mul_overflow, which reports overflow at the cost of one flag check. Sums, comparisons and lazy products
+  are computed in a type twice as wide as T (__int128 for 64-bit T) and checked before they're narrowed back;
+- multiplication cross-cancels (gcd(a, d) and gcd(c, b) for a/b * c/d) before multiplying, so the intermediate values
+  stay small and the result is already in lowest terms;
+- addition uses Knuth's trick (only gcd(b, d) and one more gcd of small numbers are needed);
+- gcd is the binary (Stein) algorithm, which only uses shifts and subtractions instead of divisions;
+- with Normalization::lazy nothing is reduced until a result no longer fits into T or the value is printed. Comparisons
+  never need reduced values since they compare cross products. This is the fastest mode for long multiply pipelines.
+
+Requires C++20 (constexpr and concepts). Everything except fromDouble() is constexpr.
+*/
+
+// Binary (Stein) greatest common divisor
+template<std::unsigned_integral U> constexpr U binaryGcd(U a, U b)
+{
+  if (a == 0) return b;
+  if (b == 0) return a;
+  // common factors of two are removed once instead of dividing them out on every step
+  int shift{ std::countr_zero(static_cast<U>(a | b)) };
+  a = static_cast<U>(a >> std::countr_zero(a));
+  int zeros{ std::countr_zero(b) };
+  for (;;) {
+    b = static_cast<U>(b >> zeros);
+    // b - a and a - b have the same trailing zeros, so the next shift doesn't wait for the comparison, and the
+    // comparison compiles to conditional moves instead of a branch that's taken at random
+    U difference{ static_cast<U>(b - a) };
+    if (difference == 0) break;
+    zeros = std::countr_zero(difference);
+    U smaller{ a < b ? a : b };
+    b = a < b ? difference : static_cast<U>(a - b);
+    a = smaller;
+  }
+  return static_cast<U>(a << shift);
+}
+
+enum class Normalization {
+  eager, // every value is kept in lowest terms
+  lazy, // values are reduced only when needed
+};
+
+template<std::signed_integral T, Normalization N = Normalization::eager> class Rational
+{
+  static_assert(sizeof(T) <= 8, "Rational<T> needs an integer type twice as wide as T");
+
+private:
+  __extension__ typedef __int128 Int128; // __extension__ keeps -pedantic-errors quiet about the GCC/Clang extension
+  using Wide = std::conditional_t<(sizeof(T) < 4), std::int32_t, std::conditional_t<sizeof(T) == 4, std::int64_t, Int128>>;
+  using Unsigned = std::make_unsigned_t<T>;
+
+  static constexpr T s_min{ std::numeric_limits<T>::min() };
+  static constexpr T s_max{ std::numeric_limits<T>::max() };
+
+  T m_numerator{ 0 };
+  T m_denominator{ 1 }; // always positive
+
+  struct Unchecked
+  {
+  };
+  // Skips validation, used for values that are known to be valid already
+  constexpr Rational(T numerator, T denominator, Unchecked) : m_numerator{ numerator }, m_denominator{ denominator } {}
+
+  static constexpr Unsigned absU(T value)
+  {
+    // works for s_min too, since the negation is done in the unsigned type
+    return value < 0 ? static_cast<Unsigned>(Unsigned{ 0 } - static_cast<Unsigned>(value)) : static_cast<Unsigned>(value);
+  }
+
+  // One of the arguments must be positive, so that the result fits into T
+  static constexpr T gcd(T a, T b) { return static_cast<T>(binaryGcd(absU(a), absU(b))); }
+
+  static constexpr Rational narrow(Wide numerator, Wide denominator)
+  {
+    if (numerator < s_min || numerator > s_max || denominator > s_max) {
+      throw std::overflow_error("Rational overflow");
+    }
+    return Rational{ static_cast<T>(numerator), static_cast<T>(denominator), Unchecked{} };
+  }
+
+  // Both arguments must be in lowest terms, the result is in lowest terms as well
+  static constexpr Rational multiplyReduced(const Rational& r1, const Rational& r2)
+  {
+    T n1{ r1.m_numerator }, d1{ r1.m_denominator }, n2{ r2.m_numerator }, d2{ r2.m_denominator };
+    // most pairs have no common factor, and a division costs more than the gcd that found it
+    if (T g1{ gcd(n1, d2) }; g1 != 1) {
+      n1 /= g1;
+      d2 /= g1;
+    }
+    if (T g2{ gcd(n2, d1) }; g2 != 1) {
+      n2 /= g2;
+      d1 /= g2;
+    }
+    T numerator{}, denominator{};
+    if (__builtin_mul_overflow(n1, n2, &numerator) || __builtin_mul_overflow(d1, d2, &denominator)) {
+      throw std::overflow_error("Rational overflow");
+    }
+    return Rational{ numerator, denominator, Unchecked{} };
+  }
+
+  // r1 + r2, or r1 - r2 if subtract is set. Both arguments must be in lowest terms, and so is the result
+  static constexpr Rational addReduced(const Rational& r1, const Rational& r2, bool subtract)
+  {
+    // negated in the wide type, where -s_min fits
+    Wide n2{ subtract ? -Wide{ r2.m_numerator } : Wide{ r2.m_numerator } };
+    T g{ gcd(r1.m_denominator, r2.m_denominator) };
+    if (g == 1) {
+      return narrow(Wide{ r1.m_numerator } * r2.m_denominator + n2 * r1.m_denominator,
+        Wide{ r1.m_denominator } * r2.m_denominator);
+    }
+    T s{ static_cast<T>(r1.m_denominator / g) };
+    Wide t{ Wide{ r1.m_numerator } * (r2.m_denominator / g) + n2 * s };
+    // gcd(t, g) == gcd(t % g, g), and t % g fits into T
+    T g2{ gcd(static_cast<T>(t % g), g) };
+    return narrow(t / g2, Wide{ s } * (r2.m_denominator / g2));
+  }
+
+  static constexpr Rational add(const Rational& r1, const Rational& r2, bool subtract)
+  {
+    if constexpr (N == Normalization::lazy) {
+      Wide n2{ Wide{ r2.m_numerator } * r1.m_denominator };
+      Wide n{ Wide{ r1.m_numerator } * r2.m_denominator + (subtract ? -n2 : n2) };
+      Wide d{ Wide{ r1.m_denominator } * r2.m_denominator };
+      if (n >= s_min && n <= s_max && d <= s_max) {
+        return Rational{ static_cast<T>(n), static_cast<T>(d), Unchecked{} };
+      }
+      return addReduced(r1.normalized(), r2.normalized(), subtract);
+    } else {
+      return addReduced(r1, r2, subtract);
+    }
+  }
+
+  // Cross products, denominators are positive so the sign of the difference gives the ordering
+  static constexpr std::pair<Wide, Wide> crossProducts(const Rational& r1, const Rational& r2)
+  {
+    return { Wide{ r1.m_numerator } * r2.m_denominator, Wide{ r2.m_numerator } * r1.m_denominator };
+  }
+
+public:
+  using value_type = T;
+
+  constexpr Rational(T numerator = 0, T denominator = 1) : m_numerator{ numerator }, m_denominator{ denominator }
+  {
+    if (denominator == 0) throw std::runtime_error("Invalid denominator");
+    if (m_denominator < 0) {
+      if (m_numerator == s_min || m_denominator == s_min) throw std::overflow_error("Rational overflow");
+      m_numerator = -m_numerator;
+      m_denominator = -m_denominator;
+    }
+    if constexpr (N == Normalization::eager) normalize();
+  }
+
+  /*
+  Closest fraction to x with a denominator of at most maxDenominator (e.g. fromDouble(3.14159265, 1000) is 355/113).
+  The continued fraction expansion of x is walked until the next convergent's denominator would be too large, then the
+  best semiconvergent is compared with the last convergent. That takes O(log maxDenominator) steps, while trying every
+  denominator takes O(maxDenominator). The result is always in lowest terms.
+  */
+  static Rational fromDouble(double x, T maxDenominator)
+  {
+    assert(maxDenominator > 0 && "Rational::fromDouble(): maxDenominator must be positive");
+    if (!std::isfinite(x)) throw std::runtime_error("Rational::fromDouble(): value is not finite");
+    const bool negative{ x < 0 };
+    const double value{ std::abs(x) };
+    if (value >= static_cast<double>(s_max)) throw std::overflow_error("Rational overflow");
+
+    // the last two convergents are p0/q0 and p1/q1
+    T p0{ 0 }, q0{ 1 }, p1{ 1 }, q1{ 0 };
+    double rest{ value };
+    for (;;) {
+      const double a{ std::floor(rest) };
+      if (q1 != 0 && a > static_cast<double>(maxDenominator - q0) / static_cast<double>(q1)) {
+        // the next convergent's denominator is too large, the best semiconvergent is the other candidate
+        T m{ static_cast<T>((maxDenominator - q0) / q1) };
+        Wide p{ Wide{ p0 } + Wide{ m } * p1 };
+        T q{ static_cast<T>(q0 + m * q1) };
+        if (p <= s_max) {
+          long double semiError{ std::abs(static_cast<long double>(value) - static_cast<long double>(p) / q) };
+          long double convergentError{ std::abs(static_cast<long double>(value) - static_cast<long double>(p1) / q1) };
+          if (semiError < convergentError) {
+            p1 = static_cast<T>(p);
+            q1 = q;
+          }
+        }
+        break;
+      }
+
+      Wide p2{ static_cast<Wide>(a) * p1 + p0 };
+      if (p2 > s_max) break; // the numerator doesn't fit, so the last convergent is the best we can represent
+      T ai{ static_cast<T>(a) };
+      T q2{ static_cast<T>(ai * q1 + q0) };
+      p0 = p1;
+      q0 = q1;
+      p1 = static_cast<T>(p2);
+      q1 = q2;
+
+      const double fraction{ rest - a };
+      if (fraction <= 0 || static_cast<double>(p1) / static_cast<double>(q1) == value) break; // exact
+      rest = 1 / fraction;
+    }
+
+    if (q1 == 0) return Rational{}; // only possible if even the integer part doesn't fit
+    return Rational{ static_cast<T>(negative ? -p1 : p1), q1, Unchecked{} };
+  }
+
+  // Batch variant of fromDouble(), out must be at least as large as values
+  static void fromDouble(std::span<const double> values, T maxDenominator, std::span<Rational> out)
+  {
+    assert(out.size() >= values.size() && "Rational::fromDouble(): output span is too small");
+    for (std::size_t i{ 0 }; i < values.size(); ++i) out[i] = fromDouble(values[i], maxDenominator);
+  }
+
+  // In lazy mode numerator() and denominator() may return a non-reduced pair, use normalized() first if it matters
+  constexpr T numerator() const { return m_numerator; }
+  constexpr T denominator() const { return m_denominator; }
+
+  constexpr void normalize()
+  {
+    T g{ gcd(m_numerator, m_denominator) };
+    if (g > 1) {
+      m_numerator /= g;
+      m_denominator /= g;
+    }
+  }
+
+  constexpr Rational normalized() const
+  {
+    Rational r{ *this };
+    r.normalize();
+    return r;
+  }
+
+  constexpr Rational reciprocal() const
+  {
+    if (m_numerator == 0) throw std::runtime_error("Division by zero");
+    if (m_numerator == s_min) throw std::overflow_error("Rational overflow");
+    return m_numerator < 0 ? Rational{ static_cast<T>(-m_denominator), static_cast<T>(-m_numerator), Unchecked{} }
+                           : Rational{ m_denominator, m_numerator, Unchecked{} };
+  }
+
+  explicit constexpr operator double() const
+  {
+    return static_cast<double>(m_numerator) / static_cast<double>(m_denominator);
+  }
+
+  constexpr Rational operator-() const
+  {
+    if (m_numerator == s_min) throw std::overflow_error("Rational overflow");
+    return Rational{ static_cast<T>(-m_numerator), m_denominator, Unchecked{} };
+  }
+
+  friend constexpr Rational operator*(const Rational& r1, const Rational& r2)
+  {
+    if constexpr (N == Normalization::lazy) {
+      Wide n{ Wide{ r1.m_numerator } * r2.m_numerator };
+      Wide d{ Wide{ r1.m_denominator } * r2.m_denominator };
+      if (n >= s_min && n <= s_max && d <= s_max) {
+        return Rational{ static_cast<T>(n), static_cast<T>(d), Unchecked{} };
+      }
+      // doesn't fit without reducing, fall back to the exact eager path
+      return multiplyReduced(r1.normalized(), r2.normalized());
+    } else {
+      return multiplyReduced(r1, r2);
+    }
+  }
+
+  friend constexpr Rational operator+(const Rational& r1, const Rational& r2) { return add(r1, r2, false); }
+  // not r1 + -r2, which would throw for a numerator of s_min even when the difference fits
+  friend constexpr Rational operator-(const Rational& r1, const Rational& r2) { return add(r1, r2, true); }
+  friend constexpr Rational operator/(const Rational& r1, const Rational& r2) { return r1 * r2.reciprocal(); }
+
+  constexpr Rational& operator*=(const Rational& r) { return *this = *this * r; }
+  constexpr Rational& operator+=(const Rational& r) { return *this = *this + r; }
+  constexpr Rational& operator-=(const Rational& r) { return *this = *this - r; }
+  constexpr Rational& operator/=(const Rational& r) { return *this = *this / r; }
+
+  // Cross products work for non-reduced values too, so lazy values are never normalized for comparisons
+  friend constexpr bool operator==(const Rational& r1, const Rational& r2)
+  {
+    auto [left, right]{ crossProducts(r1, r2) };
+    return left == right;
+  }
+
+  friend constexpr std::strong_ordering operator<=>(const Rational& r1, const Rational& r2)
+  {
+    auto [left, right]{ crossProducts(r1, r2) };
+    if (left < right) return std::strong_ordering::less;
+    if (left > right) return std::strong_ordering::greater;
+    return std::strong_ordering::equal;
+  }
+
+  friend std::ostream& operator<<(std::ostream& out, const Rational& r)
+  {
+    Rational reduced{ r.normalized() };
+    return out << reduced.m_numerator << '/' << reduced.m_denominator;
+  }
+};
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <algorithm> // for std::min
+#include <bit> // for std::countr_one, std::popcount
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new> // for std::align_val_t
+#include <span>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+Lookups in sorted arrays of ints, faster replacements for binarySearch() from 20.x_3.
+
+Every function returns the index of the first element >= key in the sorted input (lower bound), or its length if every
+element is smaller. Indices are ints like in binarySearch(), so arrays are limited to INT_MAX elements.
+
+- lowerBound() works on the sorted array itself. Its loop always runs log2(n) times and the comparison only masks
+  the step to the upper half, so there is no branch to mispredict. Without a branch the CPU no longer loads ahead
+  speculatively, so both elements the next step may read are prefetched.
+- Eytzinger stores the array in breadth-first order of the implicit search tree: the children of node k are 2k and
+  2k + 1. The top levels share a few cache lines, and the 16 great-great-grandchildren of a node are one cache line, so
+  it's prefetched 4 levels ahead and the search is limited by bandwidth instead of memory latency.
+- STree is a static B-tree with 16 keys (one cache line) per node. A node is searched with SIMD comparisons, so a
+  lookup reads log17(n) cache lines instead of log2(n).
+- binarySearchBatch() runs many branchless searches in lockstep to overlap their cache misses.
+*/
+namespace Search {
+  namespace detail {
+    // half if the condition holds, else 0, without a branch. GCC turns both `condition ? half : 0` and
+    // `condition ? base + half : base` into a jump, masking keeps it a setl, neg and and.
+    constexpr std::size_t halfIf(bool condition, std::size_t half)
+    {
+      return half & (std::size_t{ 0 } - static_cast<std::size_t>(condition));
+    }
+  } // namespace detail
+
+  // Branchless lower bound on a sorted span
+  inline int lowerBound(std::span<const int> sorted, int key)
+  {
+    if (sorted.empty()) return 0;
+    const int* base{ sorted.data() };
+    std::size_t length{ sorted.size() };
+    while (length > 1) {
+      std::size_t half{ length / 2 };
+      // the next step reads the middle of one of the two halves, fetch both while this one waits for its element
+      std::size_t nextHalf{ (length - half) / 2 };
+      if (nextHalf > 0) {
+        __builtin_prefetch(base + nextHalf - 1);
+        __builtin_prefetch(base + half + nextHalf - 1);
+      }
+      base += detail::halfIf(base[half - 1] < key, half);
+      length -= half;
+    }
+    return static_cast<int>(base - sorted.data()) + (*base < key);
+  }
+
+  // Index of key in the sorted span, -1 if it's not there (what binarySearch() returns)
+  inline int binarySearch(std::span<const int> sorted, int key)
+  {
+    auto index{ static_cast<std::size_t>(lowerBound(sorted, key)) };
+    return index < sorted.size() && sorted[index] == key ? static_cast<int>(index) : -1;
+  }
+
+  /*
+  binarySearch() for many keys: outIndices[i] is the index of keys[i] in sorted, or -1.
+
+  A single search waits for a cache miss at every level once the array is larger than the cache. Here groups of keys are
+  searched in lockstep instead: the loop runs the same number of steps for every key, so each step advances every
+  search of the group by one level (masked with halfIf() like in lowerBound(), so no search mispredicts) and prefetches
+  the element its next step will read. By the time the loop comes back to a search, its element has arrived, and the
+  misses of the whole group overlap. While the array fits into L1 there are no misses to overlap, and it's about as
+  fast as one lowerBound() per key.
+  */
+  inline void binarySearchBatch(std::span<const int> sorted, std::span<const int> keys, std::span<int> outIndices)
+  {
+    assert(outIndices.size() >= keys.size() && "Search::binarySearchBatch(): outIndices is too small");
+    if (sorted.empty()) {
+      for (std::size_t i{ 0 }; i < keys.size(); ++i) outIndices[i] = -1;
+      return;
+    }
+
+    constexpr std::size_t groupSize{ 16 };
+    for (std::size_t first{ 0 }; first < keys.size(); first += groupSize) {
+      std::size_t count{ keys.size() - first < groupSize ? keys.size() - first : groupSize };
+      const int* base[groupSize]{};
+      for (std::size_t j{ 0 }; j < count; ++j) base[j] = sorted.data();
+
+      std::size_t length{ sorted.size() };
+      while (length > 1) {
+        std::size_t half{ length / 2 };
+        std::size_t nextHalf{ (length - half) / 2 };
+        for (std::size_t j{ 0 }; j < count; ++j) {
+          base[j] += detail::halfIf(base[j][half - 1] < keys[first + j], half);
+          if (nextHalf > 0) __builtin_prefetch(base[j] + nextHalf - 1);
+        }
+        length -= half;
+      }
+
+      for (std::size_t j{ 0 }; j < count; ++j) {
+        int key{ keys[first + j] };
+        const int* found{ base[j] + (*base[j] < key) };
+        bool hit{ found != sorted.data() + sorted.size() && *found == key };
+        outIndices[first + j] = hit ? static_cast<int>(found - sorted.data()) : -1;
+      }
+    }
+  }
+
+  namespace detail {
+    struct AlignedDelete
+    {
+      void operator()(int* p) const { ::operator delete(p, std::align_val_t{ 64 }); }
+    };
+
+    // ints starting at a cache line boundary
+    using AlignedInts = std::unique_ptr<int[], AlignedDelete>;
+
+    inline AlignedInts allocateAligned(std::size_t count)
+    {
+      return AlignedInts{ static_cast<int*>(::operator new(count * sizeof(int), std::align_val_t{ 64 })) };
+    }
+  } // namespace detail
+
+  class Eytzinger
+  {
+  public:
+    // Copies a sorted span into breadth-first order
+    explicit Eytzinger(std::span<const int> sorted)
+      : m_size{ static_cast<int>(sorted.size()) }, m_keys{ detail::allocateAligned(sorted.size() + 1) },
+        m_indices{ std::make_unique_for_overwrite<int[]>(sorted.size() + 1) }
+    {
+      assert(sorted.size() < static_cast<std::size_t>(std::numeric_limits<int>::max()));
+      int next{ 0 };
+      build(sorted, 1, next);
+    }
+
+    int lowerBound(int key) const
+    {
+      const auto size{ static_cast<std::size_t>(m_size) };
+      std::size_t k{ 1 };
+      while (k <= size) {
+        // k * 16 is past the end on the last levels. A prefetch wouldn't fault there, but forming the pointer is
+        // undefined, so it's clamped (a conditional move) to the last key.
+        __builtin_prefetch(m_keys.get() + std::min(k * 16, size));
+        k = 2 * k + (m_keys[k] < key);
+      }
+      // k went right at the last levels, and left once at the answer: undo the trailing right turns and that left one
+      k >>= std::countr_one(k) + 1;
+      return k == 0 ? m_size : m_indices[k];
+    }
+
+    int size() const { return m_size; }
+
+  private:
+    int m_size{};
+    detail::AlignedInts m_keys{}; // 1-based, node k has children 2k and 2k + 1
+    std::unique_ptr<int[]> m_indices{}; // index in the sorted input of each node
+
+    // In-order traversal of the implicit tree, so the nodes get the sorted values in order
+    void build(std::span<const int> sorted, std::size_t k, int& next)
+    {
+      if (k > sorted.size()) return;
+      build(sorted, 2 * k, next);
+      m_keys[k] = sorted[static_cast<std::size_t>(next)];
+      m_indices[k] = next++;
+      build(sorted, 2 * k + 1, next);
+    }
+  };
+
+  class STree
+  {
+  public:
+    static constexpr int nodeSize{ 16 };
+
+    explicit STree(std::span<const int> sorted)
+      : m_size{ static_cast<int>(sorted.size()) }, m_nodeCount{ (sorted.size() + nodeSize - 1) / nodeSize },
+        m_keys{ detail::allocateAligned(m_nodeCount * nodeSize) },
+        m_indices{ std::make_unique_for_overwrite<int[]>(m_nodeCount * nodeSize) }
+    {
+      assert(sorted.size() < static_cast<std::size_t>(std::numeric_limits<int>::max()));
+      int next{ 0 };
+      build(sorted, 0, next);
+    }
+
+    int lowerBound(int key) const
+    {
+      int result{ m_size };
+      std::size_t k{ 0 };
+      while (k < m_nodeCount) {
+        const int* node{ m_keys.get() + k * nodeSize };
+        int i{ countLess(node, key) };
+        if (i < nodeSize) result = m_indices[k * nodeSize + static_cast<std::size_t>(i)];
+        k = child(k, i);
+      }
+      return result;
+    }
+
+    int size() const { return m_size; }
+
+  private:
+    int m_size{};
+    std::size_t m_nodeCount{};
+    detail::AlignedInts m_keys{}; // node k holds keys [16k, 16k + 16), padded with INT_MAX
+    std::unique_ptr<int[]> m_indices{};
+
+    // Node k has 17 children: child i holds the keys between key i - 1 and key i of node k
+    static std::size_t child(std::size_t k, int i) { return k * (nodeSize + 1) + static_cast<std::size_t>(i) + 1; }
+
+    void build(std::span<const int> sorted, std::size_t k, int& next)
+    {
+      if (k >= m_nodeCount) return;
+      for (int i{ 0 }; i < nodeSize; ++i) {
+        build(sorted, child(k, i), next);
+        std::size_t slot{ k * nodeSize + static_cast<std::size_t>(i) };
+        bool padding{ next >= m_size };
+        m_keys[slot] = padding ? std::numeric_limits<int>::max() : sorted[static_cast<std::size_t>(next)];
+        m_indices[slot] = padding ? m_size : next++;
+      }
+      build(sorted, child(k, nodeSize), next);
+    }
+
+    // Number of keys in the node that are less than key (the node is sorted, so that's the position of the lower bound)
+    static int countLess(const int* node, int key)
+    {
+#if defined(__SSE2__)
+      __m128i x{ _mm_set1_epi32(key) };
+      std::uint64_t mask{ 0 };
+      for (int i{ 0 }; i < nodeSize; i += 4) {
+        __m128i keys{ _mm_load_si128(reinterpret_cast<const __m128i*>(node + i)) };
+        // one bit per byte, so 4 bits per int and 16 bits per vector
+        mask |= static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpgt_epi32(x, keys))) << (i * 4);
+      }
+      return std::popcount(mask) / 4;
+#else
+      int count{ 0 };
+      for (int i{ 0 }; i < nodeSize; ++i) count += node[i] < key;
+      return count;
+#endif
+    }
+  };
+} // namespace Search
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef SORTED_MULTISET_H
+#define SORTED_MULTISET_H
+
+#include <algorithm> // for std::sort, std::lower_bound
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+Numbers that are looked up, removed one at a time and searched for the closest one, for the guessing game of 20.7_3
+with millions of numbers. There, findAndRemove() is a std::find plus a vector::erase that shifts the whole tail, and
+findClosestNumber() looks at every number: O(n) per guess, O(n^2) per game.
+
+Here the numbers are sorted once and never moved. Erasing one leaves a tombstone: it's skipped by links that point past
+it, one set to the next number that's still there and one set to the previous one. Runs of tombstones are skipped in
+a single step, because following the links also shortens them (path halving, like in a disjoint set forest). A lookup is
+then a binary search plus an amortized almost constant walk over the links:
+- eraseOne(), contains() and nearest() are O(log n);
+- once more than half of the numbers are erased, the rest are copied into a new, smaller array (compaction), which is
+  O(1) amortized per erase and keeps the binary search and the memory in proportion to what's left.
+
+The numbers are given all at once to the constructor, there's no insert. Lookups shorten the links too, so even const
+member functions must not be called from several threads at once.
+*/
+template<typename T>
+  requires std::is_arithmetic_v<T>
+class SortedMultiset
+{
+public:
+  SortedMultiset() { resetLinks(); }
+
+  explicit SortedMultiset(std::vector<T> values) : m_values{ std::move(values) }
+  {
+    assert(m_values.size() < std::numeric_limits<std::uint32_t>::max() && "SortedMultiset(): too many values");
+    std::sort(m_values.begin(), m_values.end());
+    resetLinks();
+  }
+
+  std::size_t size() const { return m_values.size() - m_erased; }
+  bool empty() const { return size() == 0; }
+
+  bool contains(T value) const { return findLive(value) != end(); }
+
+  // Removes one element equal to value. Returns false if there's none.
+  bool eraseOne(T value)
+  {
+    std::uint32_t index{ findLive(value) };
+    if (index == end()) return false;
+    m_next[index] = index + 1;
+    m_previous[index + 1] = index;
+    ++m_erased;
+    if (m_erased * 2 > m_values.size()) compact();
+    return true;
+  }
+
+  // The element closest to value (the smaller one of two equally close ones), or std::nullopt if there are none
+  std::optional<T> nearest(T value) const
+  {
+    if (empty()) return std::nullopt;
+    std::uint32_t position{ lowerBound(value) };
+    std::uint32_t above{ root(m_next, position) }; // first element >= value, end() if none
+    std::uint32_t belowEnd{ root(m_previous, position) }; // one past the last element < value, 0 if none
+    if (above == end()) return m_values[belowEnd - 1];
+    if (belowEnd == 0) return m_values[above];
+    T below{ m_values[belowEnd - 1] };
+    return distance(below, value) <= distance(value, m_values[above]) ? below : m_values[above];
+  }
+
+  // The remaining elements in ascending order
+  std::vector<T> toVector() const
+  {
+    std::vector<T> values{};
+    values.reserve(size());
+    for (std::uint32_t i{ root(m_next, 0) }; i != end(); i = root(m_next, i + 1)) values.push_back(m_values[i]);
+    return values;
+  }
+
+private:
+  std::vector<T> m_values{}; // sorted, including the erased ones
+  // m_next[i] is i if element i is still there, otherwise it leads to a later index: the root of i is the first element
+  // at or after i that isn't erased. m_next[size] = size is the end.
+  mutable std::vector<std::uint32_t> m_next{};
+  // The same towards the front, shifted by one: the root of m_previous[i] is one past the last element before i that
+  // isn't erased. m_previous[0] = 0 is the front.
+  mutable std::vector<std::uint32_t> m_previous{};
+  std::size_t m_erased{ 0 };
+
+  std::uint32_t end() const { return static_cast<std::uint32_t>(m_values.size()); }
+
+  std::uint32_t lowerBound(T value) const
+  {
+    return static_cast<std::uint32_t>(std::lower_bound(m_values.begin(), m_values.end(), value) - m_values.begin());
+  }
+
+  // Index of an element equal to value that isn't erased, end() if there's none
+  std::uint32_t findLive(T value) const
+  {
+    std::uint32_t index{ root(m_next, lowerBound(value)) };
+    return (index != end() && m_values[index] == value) ? index : end();
+  }
+
+  // Follows the links to the first index that links to itself, making every other step link two ahead
+  static std::uint32_t root(std::vector<std::uint32_t>& links, std::uint32_t index)
+  {
+    while (links[index] != index) {
+      links[index] = links[links[index]];
+      index = links[index];
+    }
+    return index;
+  }
+
+  // to - from, for from <= to, without overflowing (INT_MAX - INT_MIN doesn't fit in an int, but it does in unsigned)
+  static auto distance(T from, T to)
+  {
+    if constexpr (std::is_integral_v<T>) {
+      using Unsigned = std::make_unsigned_t<T>;
+      return static_cast<Unsigned>(static_cast<Unsigned>(to) - static_cast<Unsigned>(from));
+    } else {
+      return to - from;
+    }
+  }
+
+  void resetLinks()
+  {
+    m_next.resize(m_values.size() + 1);
+    m_previous.resize(m_values.size() + 1);
+    for (std::uint32_t i{ 0 }; i <= end(); ++i) m_next[i] = m_previous[i] = i;
+    m_erased = 0;
+  }
+
+  void compact()
+  {
+    m_values = toVector();
+    m_next.clear();
+    m_previous.clear();
+    m_next.shrink_to_fit();
+    m_previous.shrink_to_fit();
+    resetLinks();
+  }
+};
+
+#endif
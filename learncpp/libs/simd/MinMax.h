@@ -0,0 +1,364 @@
+#ifndef MIN_MAX_H
+#define MIN_MAX_H
+
+#include "../threads/ThreadPool.h"
+#include <algorithm> // for std::min
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <span>
+#include <type_traits>
+#include <vector>
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+/*
+Smallest and largest element of a span together with their first indices, in one pass: findMinMax() from 16.x_3 for
+large columns of int32, int64, float and double.
+
+The vectorized kernels keep, in every SIMD lane, the smallest and largest value seen in that lane and the index where it
+was seen. Each step loads a vector, compares it with both, and blends the new values and their indices in where they're
+strictly smaller (larger), so a lane keeps the first occurrence. Two sets of accumulators are interleaved so that the
+blends of one vector don't wait for those of the previous one. At the end the lanes are reduced to one result,
+preferring the lower index on ties, and the elements that didn't fill a vector are handled one by one.
+
+Which kernel is used is decided at compile time, like the BMI2 paths in Bits.h: AVX2 with -mavx2 (or -march=native on a
+CPU that has it), SSE4.2 with -msse4.2, otherwise a scalar loop. 32-bit element types use 32-bit lane indices, so the
+input is processed in blocks of 2^31 elements.
+
+findMinMax(values, pool) splits large inputs into one block per thread of the pool and combines the results.
+
+Floating-point inputs must not contain NaNs (every comparison with a NaN is false, so the results would depend on where
+the NaN is).
+*/
+namespace MinMax {
+  template<typename T> struct Result
+  {
+    T min{};
+    std::size_t minIndex{};
+    T max{};
+    std::size_t maxIndex{};
+  };
+
+  template<typename T>
+  concept Element = std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t> || std::same_as<T, float>
+                    || std::same_as<T, double>;
+
+  namespace detail {
+    // Combines the results of two blocks, b comes after a in the input
+    template<typename T> Result<T> combine(const Result<T>& a, const Result<T>& b)
+    {
+      Result<T> result{ a };
+      if (b.min < a.min) {
+        result.min = b.min;
+        result.minIndex = b.minIndex;
+      }
+      if (b.max > a.max) {
+        result.max = b.max;
+        result.maxIndex = b.maxIndex;
+      }
+      return result;
+    }
+
+    // findMinMax() from 16.x_3, values must not be empty
+    template<typename T> Result<T> findMinMaxScalar(const T* values, std::size_t count, std::size_t offset)
+    {
+      Result<T> result{ values[0], offset, values[0], offset };
+      for (std::size_t i{ 1 }; i < count; ++i) {
+        if (values[i] < result.min) {
+          result.min = values[i];
+          result.minIndex = offset + i;
+        }
+        if (values[i] > result.max) {
+          result.max = values[i];
+          result.maxIndex = offset + i;
+        }
+      }
+      return result;
+    }
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+    /*
+    One struct per element type and instruction set, with what the kernel needs:
+    - Vector, Index: a vector of elements and the vector of their indices (integers of the same width);
+    - lanes: elements per vector;
+    - load, less(a, b) (a mask of the lanes where a < b), blend(a, b, mask) (b where the mask is set, else a),
+      blendIndex, indices(first) (first, first + 1, ...), and store/storeIndex.
+    */
+    template<typename T> struct Simd;
+
+#if defined(__AVX2__)
+    template<> struct Simd<std::int32_t>
+    {
+      using Vector = __m256i;
+      using Index = __m256i;
+      using IndexType = std::int32_t;
+      static constexpr std::size_t lanes{ 8 };
+      static Vector load(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+      static Vector less(Vector a, Vector b) { return _mm256_cmpgt_epi32(b, a); }
+      static Vector blend(Vector a, Vector b, Vector mask) { return _mm256_blendv_epi8(a, b, mask); }
+      static Index blendIndex(Index a, Index b, Vector mask) { return _mm256_blendv_epi8(a, b, mask); }
+      static Index indices(IndexType first)
+      {
+        return _mm256_add_epi32(_mm256_set1_epi32(first), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+      }
+      static Index add(Index a, IndexType b) { return _mm256_add_epi32(a, _mm256_set1_epi32(b)); }
+      static void store(std::int32_t* p, Vector v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+      static void storeIndex(IndexType* p, Index v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    };
+
+    template<> struct Simd<std::int64_t>
+    {
+      using Vector = __m256i;
+      using Index = __m256i;
+      using IndexType = std::int64_t;
+      static constexpr std::size_t lanes{ 4 };
+      static Vector load(const std::int64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+      static Vector less(Vector a, Vector b) { return _mm256_cmpgt_epi64(b, a); }
+      static Vector blend(Vector a, Vector b, Vector mask) { return _mm256_blendv_epi8(a, b, mask); }
+      static Index blendIndex(Index a, Index b, Vector mask) { return _mm256_blendv_epi8(a, b, mask); }
+      static Index indices(IndexType first)
+      {
+        return _mm256_add_epi64(_mm256_set1_epi64x(first), _mm256_setr_epi64x(0, 1, 2, 3));
+      }
+      static Index add(Index a, IndexType b) { return _mm256_add_epi64(a, _mm256_set1_epi64x(b)); }
+      static void store(std::int64_t* p, Vector v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+      static void storeIndex(IndexType* p, Index v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    };
+
+    template<> struct Simd<float>
+    {
+      using Vector = __m256;
+      using Index = __m256i;
+      using IndexType = std::int32_t;
+      static constexpr std::size_t lanes{ 8 };
+      static Vector load(const float* p) { return _mm256_loadu_ps(p); }
+      static Vector less(Vector a, Vector b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+      static Vector blend(Vector a, Vector b, Vector mask) { return _mm256_blendv_ps(a, b, mask); }
+      static Index blendIndex(Index a, Index b, Vector mask)
+      {
+        return _mm256_blendv_epi8(a, b, _mm256_castps_si256(mask));
+      }
+      static Index indices(IndexType first) { return Simd<std::int32_t>::indices(first); }
+      static Index add(Index a, IndexType b) { return Simd<std::int32_t>::add(a, b); }
+      static void store(float* p, Vector v) { _mm256_storeu_ps(p, v); }
+      static void storeIndex(IndexType* p, Index v) { Simd<std::int32_t>::storeIndex(p, v); }
+    };
+
+    template<> struct Simd<double>
+    {
+      using Vector = __m256d;
+      using Index = __m256i;
+      using IndexType = std::int64_t;
+      static constexpr std::size_t lanes{ 4 };
+      static Vector load(const double* p) { return _mm256_loadu_pd(p); }
+      static Vector less(Vector a, Vector b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+      static Vector blend(Vector a, Vector b, Vector mask) { return _mm256_blendv_pd(a, b, mask); }
+      static Index blendIndex(Index a, Index b, Vector mask)
+      {
+        return _mm256_blendv_epi8(a, b, _mm256_castpd_si256(mask));
+      }
+      static Index indices(IndexType first) { return Simd<std::int64_t>::indices(first); }
+      static Index add(Index a, IndexType b) { return Simd<std::int64_t>::add(a, b); }
+      static void store(double* p, Vector v) { _mm256_storeu_pd(p, v); }
+      static void storeIndex(IndexType* p, Index v) { Simd<std::int64_t>::storeIndex(p, v); }
+    };
+#else
+    template<> struct Simd<std::int32_t>
+    {
+      using Vector = __m128i;
+      using Index = __m128i;
+      using IndexType = std::int32_t;
+      static constexpr std::size_t lanes{ 4 };
+      static Vector load(const std::int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+      static Vector less(Vector a, Vector b) { return _mm_cmpgt_epi32(b, a); }
+      static Vector blend(Vector a, Vector b, Vector mask) { return _mm_blendv_epi8(a, b, mask); }
+      static Index blendIndex(Index a, Index b, Vector mask) { return _mm_blendv_epi8(a, b, mask); }
+      static Index indices(IndexType first) { return _mm_add_epi32(_mm_set1_epi32(first), _mm_setr_epi32(0, 1, 2, 3)); }
+      static Index add(Index a, IndexType b) { return _mm_add_epi32(a, _mm_set1_epi32(b)); }
+      static void store(std::int32_t* p, Vector v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+      static void storeIndex(IndexType* p, Index v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    };
+
+    template<> struct Simd<std::int64_t>
+    {
+      using Vector = __m128i;
+      using Index = __m128i;
+      using IndexType = std::int64_t;
+      static constexpr std::size_t lanes{ 2 };
+      static Vector load(const std::int64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+      static Vector less(Vector a, Vector b) { return _mm_cmpgt_epi64(b, a); }
+      static Vector blend(Vector a, Vector b, Vector mask) { return _mm_blendv_epi8(a, b, mask); }
+      static Index blendIndex(Index a, Index b, Vector mask) { return _mm_blendv_epi8(a, b, mask); }
+      static Index indices(IndexType first) { return _mm_add_epi64(_mm_set1_epi64x(first), _mm_set_epi64x(1, 0)); }
+      static Index add(Index a, IndexType b) { return _mm_add_epi64(a, _mm_set1_epi64x(b)); }
+      static void store(std::int64_t* p, Vector v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+      static void storeIndex(IndexType* p, Index v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    };
+
+    template<> struct Simd<float>
+    {
+      using Vector = __m128;
+      using Index = __m128i;
+      using IndexType = std::int32_t;
+      static constexpr std::size_t lanes{ 4 };
+      static Vector load(const float* p) { return _mm_loadu_ps(p); }
+      static Vector less(Vector a, Vector b) { return _mm_cmplt_ps(a, b); }
+      static Vector blend(Vector a, Vector b, Vector mask) { return _mm_blendv_ps(a, b, mask); }
+      static Index blendIndex(Index a, Index b, Vector mask) { return _mm_blendv_epi8(a, b, _mm_castps_si128(mask)); }
+      static Index indices(IndexType first) { return Simd<std::int32_t>::indices(first); }
+      static Index add(Index a, IndexType b) { return Simd<std::int32_t>::add(a, b); }
+      static void store(float* p, Vector v) { _mm_storeu_ps(p, v); }
+      static void storeIndex(IndexType* p, Index v) { Simd<std::int32_t>::storeIndex(p, v); }
+    };
+
+    template<> struct Simd<double>
+    {
+      using Vector = __m128d;
+      using Index = __m128i;
+      using IndexType = std::int64_t;
+      static constexpr std::size_t lanes{ 2 };
+      static Vector load(const double* p) { return _mm_loadu_pd(p); }
+      static Vector less(Vector a, Vector b) { return _mm_cmplt_pd(a, b); }
+      static Vector blend(Vector a, Vector b, Vector mask) { return _mm_blendv_pd(a, b, mask); }
+      static Index blendIndex(Index a, Index b, Vector mask) { return _mm_blendv_epi8(a, b, _mm_castpd_si128(mask)); }
+      static Index indices(IndexType first) { return Simd<std::int64_t>::indices(first); }
+      static Index add(Index a, IndexType b) { return Simd<std::int64_t>::add(a, b); }
+      static void store(double* p, Vector v) { _mm_storeu_pd(p, v); }
+      static void storeIndex(IndexType* p, Index v) { Simd<std::int64_t>::storeIndex(p, v); }
+    };
+#endif
+
+    // count must be at least 2 vectors and fit into the index type
+    template<typename T> Result<T> findMinMaxSimd(const T* values, std::size_t count, std::size_t offset)
+    {
+      using S = Simd<T>;
+      using IndexType = typename S::IndexType;
+      constexpr std::size_t lanes{ S::lanes };
+      constexpr auto step{ static_cast<IndexType>(2 * lanes) };
+
+      typename S::Vector min0{ S::load(values) };
+      typename S::Vector min1{ S::load(values + lanes) };
+      typename S::Vector max0{ min0 };
+      typename S::Vector max1{ min1 };
+      typename S::Index index0{ S::indices(0) };
+      typename S::Index index1{ S::indices(static_cast<IndexType>(lanes)) };
+      typename S::Index minIndex0{ index0 };
+      typename S::Index minIndex1{ index1 };
+      typename S::Index maxIndex0{ index0 };
+      typename S::Index maxIndex1{ index1 };
+
+      std::size_t i{ 2 * lanes };
+      for (; i + 2 * lanes <= count; i += 2 * lanes) {
+        index0 = S::add(index0, step);
+        index1 = S::add(index1, step);
+        typename S::Vector v0{ S::load(values + i) };
+        typename S::Vector v1{ S::load(values + i + lanes) };
+
+        typename S::Vector less0{ S::less(v0, min0) };
+        typename S::Vector less1{ S::less(v1, min1) };
+        typename S::Vector greater0{ S::less(max0, v0) };
+        typename S::Vector greater1{ S::less(max1, v1) };
+        min0 = S::blend(min0, v0, less0);
+        min1 = S::blend(min1, v1, less1);
+        minIndex0 = S::blendIndex(minIndex0, index0, less0);
+        minIndex1 = S::blendIndex(minIndex1, index1, less1);
+        max0 = S::blend(max0, v0, greater0);
+        max1 = S::blend(max1, v1, greater1);
+        maxIndex0 = S::blendIndex(maxIndex0, index0, greater0);
+        maxIndex1 = S::blendIndex(maxIndex1, index1, greater1);
+      }
+
+      // reduce the 2 * lanes candidates, the lower index wins ties
+      T mins[2 * lanes];
+      T maxs[2 * lanes];
+      IndexType minIndices[2 * lanes];
+      IndexType maxIndices[2 * lanes];
+      S::store(mins, min0);
+      S::store(mins + lanes, min1);
+      S::store(maxs, max0);
+      S::store(maxs + lanes, max1);
+      S::storeIndex(minIndices, minIndex0);
+      S::storeIndex(minIndices + lanes, minIndex1);
+      S::storeIndex(maxIndices, maxIndex0);
+      S::storeIndex(maxIndices + lanes, maxIndex1);
+
+      Result<T> result{ mins[0], static_cast<std::size_t>(minIndices[0]), maxs[0],
+        static_cast<std::size_t>(maxIndices[0]) };
+      for (std::size_t lane{ 1 }; lane < 2 * lanes; ++lane) {
+        auto minIndex{ static_cast<std::size_t>(minIndices[lane]) };
+        if (mins[lane] < result.min || (mins[lane] == result.min && minIndex < result.minIndex)) {
+          result.min = mins[lane];
+          result.minIndex = minIndex;
+        }
+        auto maxIndex{ static_cast<std::size_t>(maxIndices[lane]) };
+        if (maxs[lane] > result.max || (maxs[lane] == result.max && maxIndex < result.maxIndex)) {
+          result.max = maxs[lane];
+          result.maxIndex = maxIndex;
+        }
+      }
+      result.minIndex += offset;
+      result.maxIndex += offset;
+
+      // the rest comes after everything above, so it only wins when it's strictly better
+      if (i < count) result = combine(result, findMinMaxScalar(values + i, count - i, offset + i));
+      return result;
+    }
+#endif
+
+    // values[0, count) are at offset in the whole input
+    template<typename T> Result<T> findMinMaxBlock(const T* values, std::size_t count, std::size_t offset)
+    {
+#if defined(__AVX2__) || defined(__SSE4_2__)
+      // the index lanes of 32-bit types are 32-bit as well
+      constexpr std::size_t maxBlock{ std::size_t{ 1 } << 31 };
+      if (count >= 2 * Simd<T>::lanes) {
+        Result<T> result{ findMinMaxSimd(values, std::min(count, maxBlock), offset) };
+        for (std::size_t first{ maxBlock }; first < count; first += maxBlock) {
+          std::size_t blockSize{ std::min(count - first, maxBlock) };
+          const T* block{ values + first };
+          result = combine(result, blockSize >= 2 * Simd<T>::lanes
+                                     ? findMinMaxSimd(block, blockSize, offset + first)
+                                     : findMinMaxScalar(block, blockSize, offset + first));
+        }
+        return result;
+      }
+#endif
+      return findMinMaxScalar(values, count, offset);
+    }
+  } // namespace detail
+
+  // values must not be empty
+  template<Element T> Result<T> findMinMax(std::span<const T> values)
+  {
+    assert(!values.empty() && "MinMax::findMinMax(): no elements");
+    return detail::findMinMaxBlock(values.data(), values.size(), 0);
+  }
+
+  // Splits inputs of millions of elements over the threads of the pool
+  template<Element T> Result<T> findMinMax(std::span<const T> values, ThreadPool& pool)
+  {
+    assert(!values.empty() && "MinMax::findMinMax(): no elements");
+    // smaller blocks finish faster than it takes to hand them to another thread
+    constexpr std::size_t minBlock{ 1 << 20 };
+    std::size_t blocks{ std::min<std::size_t>(pool.size(), (values.size() + minBlock - 1) / minBlock) };
+    if (blocks < 2) return findMinMax(values);
+
+    std::vector<std::future<Result<T>>> results{};
+    for (std::size_t b{ 0 }; b < blocks; ++b) {
+      std::size_t first{ b * values.size() / blocks };
+      std::size_t last{ (b + 1) * values.size() / blocks };
+      results.push_back(pool.submit([values, first, last] {
+        return detail::findMinMaxBlock(values.data() + first, last - first, first);
+      }));
+    }
+    Result<T> result{ results[0].get() };
+    for (std::size_t b{ 1 }; b < blocks; ++b) result = detail::combine(result, results[b].get());
+    return result;
+  }
+} // namespace MinMax
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include "../threads/ThreadPool.h"
+#include "Sort.h"
+#include <algorithm> // for std::upper_bound, std::min
+#include <cstddef>
+#include <cstdint>
+#include <exception> // for std::exception_ptr
+#include <functional> // for std::less
+#include <future>
+#include <iterator>
+#include <limits>
+#include <memory> // for std::allocator, std::construct_at, std::destroy
+#include <vector>
+
+/*
+Sort::sort() with execution policy tags, like std::sort(std::execution::par, ...):
+- Sort::sort(Sort::seq, first, last) is Sort::pdqsort();
+- Sort::sort(Sort::par, first, last) is a parallel sample sort on ThreadPool::global(), and
+  Sort::sort(Sort::ParallelPolicy{ &pool }, first, last) runs it on a pool of your choosing.
+
+Sample sort splits the input into one bucket per range of values, so the buckets can be sorted independently and are
+already in order when they're done: there's no merge step that would run on fewer threads at the end.
+1. Splitters between the buckets are picked from a sorted sample of the input (32 elements per bucket, so the buckets
+   come out about the same size). There are 4 buckets per thread, so a thread that got a larger bucket doesn't hold up
+   all the others.
+2. Every thread finds the bucket of each element of its slice of the input (a binary search among the splitters) and
+   counts them. Prefix sums of the counts tell each thread where its elements of each bucket go.
+3. Every thread moves its elements into their buckets in a buffer.
+4. Every bucket is sorted with pdqsort() and moved back, in as many tasks as there are buckets.
+
+Every element is moved twice and compared O(log n) times. The comparator must not throw.
+*/
+namespace Sort {
+  struct SequencedPolicy
+  {};
+
+  struct ParallelPolicy
+  {
+    ThreadPool* pool{ nullptr }; // nullptr is ThreadPool::global()
+  };
+
+  inline constexpr SequencedPolicy seq{};
+  inline constexpr ParallelPolicy par{};
+
+  namespace detail {
+    // Inputs smaller than this are sorted on the calling thread, splitting them costs more than it saves
+    constexpr std::size_t parallelSortThreshold{ 1 << 15 };
+    constexpr std::size_t samplesPerBucket{ 32 };
+    constexpr std::size_t bucketsPerThread{ 4 };
+
+    // Runs function(0), ..., function(count - 1) on the pool and waits for all of them. If any of them throws, the
+    // first exception is rethrown, but only once every task is done: the others still use function and the caller's
+    // buffers, which must outlive them.
+    template<typename Function> void parallelFor(ThreadPool& pool, std::size_t count, Function function)
+    {
+      std::exception_ptr error{};
+      std::vector<std::future<void>> done{};
+      try {
+        done.reserve(count);
+        for (std::size_t i{ 0 }; i < count; ++i) done.push_back(pool.submit([&function, i] { function(i); }));
+      } catch (...) {
+        // the tasks submitted so far are waited for all the same
+        error = std::current_exception();
+      }
+      for (auto& d : done) {
+        try {
+          d.get();
+        } catch (...) {
+          if (!error) error = std::current_exception();
+        }
+      }
+      if (error) std::rethrow_exception(error);
+    }
+
+    template<typename It, typename Compare> void sampleSort(ThreadPool& pool, It first, It last, Compare comp)
+    {
+      using T = std::iter_value_t<It>;
+      auto n{ static_cast<std::size_t>(last - first) };
+      std::size_t threads{ pool.size() };
+      if (threads < 2 || n < parallelSortThreshold) {
+        pdqsort(first, last, comp);
+        return;
+      }
+
+      // 1. splitters, from evenly spaced samples (already sorted inputs give perfectly even buckets)
+      constexpr std::size_t maxBuckets{ std::numeric_limits<std::uint16_t>::max() };
+      std::size_t bucketCount{ std::min(threads * bucketsPerThread, maxBuckets) };
+      std::size_t sampleCount{ bucketCount * samplesPerBucket };
+      std::vector<T> sample{};
+      sample.reserve(sampleCount);
+      for (std::size_t i{ 0 }; i < sampleCount; ++i) {
+        sample.push_back(first[static_cast<std::ptrdiff_t>(i * n / sampleCount)]);
+      }
+      pdqsort(sample.begin(), sample.end(), comp);
+      std::vector<T> splitters{};
+      splitters.reserve(bucketCount - 1);
+      for (std::size_t b{ 1 }; b < bucketCount; ++b) splitters.push_back(sample[b * samplesPerBucket]);
+
+      // 2. bucket of every element, counted per slice
+      std::size_t sliceCount{ threads };
+      auto sliceBegin{ [n, sliceCount](std::size_t s) { return s * n / sliceCount; } };
+      std::vector<std::uint16_t> bucketOf(n);
+      std::vector<std::vector<std::size_t>> positions(sliceCount, std::vector<std::size_t>(bucketCount));
+      parallelFor(pool, sliceCount, [&](std::size_t s) {
+        for (std::size_t i{ sliceBegin(s) }; i < sliceBegin(s + 1); ++i) {
+          auto bucket{ std::upper_bound(splitters.begin(), splitters.end(), first[static_cast<std::ptrdiff_t>(i)], comp)
+                       - splitters.begin() };
+          bucketOf[i] = static_cast<std::uint16_t>(bucket);
+          ++positions[s][static_cast<std::size_t>(bucket)];
+        }
+      });
+
+      // the elements of bucket b from slice s go after those of all smaller buckets, and those of b from earlier slices
+      std::vector<std::size_t> bucketBegin(bucketCount + 1);
+      std::size_t position{ 0 };
+      for (std::size_t b{ 0 }; b < bucketCount; ++b) {
+        bucketBegin[b] = position;
+        for (std::size_t s{ 0 }; s < sliceCount; ++s) {
+          std::size_t count{ positions[s][b] };
+          positions[s][b] = position;
+          position += count;
+        }
+      }
+      bucketBegin[bucketCount] = n;
+
+      // 3. move into the buckets, the buffer is raw memory so T doesn't need a default constructor
+      std::allocator<T> allocator{};
+      T* buffer{ allocator.allocate(n) };
+      parallelFor(pool, sliceCount, [&](std::size_t s) {
+        for (std::size_t i{ sliceBegin(s) }; i < sliceBegin(s + 1); ++i) {
+          std::construct_at(buffer + positions[s][bucketOf[i]]++, std::move(first[static_cast<std::ptrdiff_t>(i)]));
+        }
+      });
+
+      // 4. sort the buckets and move them back
+      parallelFor(pool, bucketCount, [&](std::size_t b) {
+        T* bucketFirst{ buffer + bucketBegin[b] };
+        T* bucketLast{ buffer + bucketBegin[b + 1] };
+        pdqsort(bucketFirst, bucketLast, comp);
+        std::move(bucketFirst, bucketLast, first + static_cast<std::ptrdiff_t>(bucketBegin[b]));
+        std::destroy(bucketFirst, bucketLast);
+      });
+      allocator.deallocate(buffer, n);
+    }
+  } // namespace detail
+
+  template<std::random_access_iterator It, typename Compare = std::less<>>
+  void sort(SequencedPolicy, It first, It last, Compare comp = Compare{})
+  {
+    pdqsort(first, last, comp);
+  }
+
+  template<std::random_access_iterator It, typename Compare = std::less<>>
+  void sort(ParallelPolicy policy, It first, It last, Compare comp = Compare{})
+  {
+    detail::sampleSort(policy.pool ? *policy.pool : ThreadPool::global(), first, last, comp);
+  }
+} // namespace Sort
+
+#endif
@@ -0,0 +1,357 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <algorithm> // for std::make_heap, std::sort_heap, std::min, std::max
+#include <array>
+#include <bit> // for std::bit_width
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional> // for std::less
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+/*
+Sorting algorithms to pick from by workload, see ch18/sorts.cpp for how they compare:
+- pdqsort(): pattern-defeating quicksort (https://github.com/orlp/pdqsort). Introsort with a few cheap checks on top:
+  partitions that didn't have to move anything are finished with an insertion sort that gives up after a few moves, so
+  sorted and reversed inputs take O(n); runs of equal elements are put aside in one pass; and unbalanced partitions
+  shuffle the pivot candidates, falling back to heapsort if that keeps happening. O(n log n) worst case, not stable.
+- radixSort(): LSD radix sort of 32- and 64-bit integers, one pass per byte. O(n) and no comparisons at all, but it
+  needs a buffer as large as the input. Passes where every key has the same byte are skipped.
+- networkSort(): sorts up to 16 elements with a fixed sequence of compare-exchanges (Batcher's merge-exchange network).
+  Which elements are compared doesn't depend on the data, and every compare-exchange is a min and a max, so there's
+  nothing to mispredict.
+*/
+namespace Sort {
+  namespace detail {
+    // Partitions below this size are insertion sorted
+    constexpr std::ptrdiff_t insertionSortThreshold{ 24 };
+    // Partitions above this size use the median of 3 medians of 3 as the pivot
+    constexpr std::ptrdiff_t nintherThreshold{ 128 };
+    // partialInsertionSort() gives up after this many element moves
+    constexpr std::ptrdiff_t partialInsertionSortLimit{ 8 };
+
+    template<typename It, typename Compare> void insertionSort(It begin, It end, Compare comp)
+    {
+      if (begin == end) return;
+      for (It current{ begin + 1 }; current != end; ++current) {
+        It sift{ current };
+        It siftPrevious{ current - 1 };
+        if (comp(*sift, *siftPrevious)) {
+          auto value{ std::move(*sift) };
+          do {
+            *sift-- = std::move(*siftPrevious);
+          } while (sift != begin && comp(value, *--siftPrevious));
+          *sift = std::move(value);
+        }
+      }
+    }
+
+    // Insertion sort that doesn't check for begin: the element before begin must not be greater than any in the range
+    template<typename It, typename Compare> void unguardedInsertionSort(It begin, It end, Compare comp)
+    {
+      if (begin == end) return;
+      for (It current{ begin + 1 }; current != end; ++current) {
+        It sift{ current };
+        It siftPrevious{ current - 1 };
+        if (comp(*sift, *siftPrevious)) {
+          auto value{ std::move(*sift) };
+          do {
+            *sift-- = std::move(*siftPrevious);
+          } while (comp(value, *--siftPrevious));
+          *sift = std::move(value);
+        }
+      }
+    }
+
+    // Insertion sort that returns false (leaving the range partially sorted) once it has moved too many elements
+    template<typename It, typename Compare> bool partialInsertionSort(It begin, It end, Compare comp)
+    {
+      if (begin == end) return true;
+      std::ptrdiff_t moves{ 0 };
+      for (It current{ begin + 1 }; current != end; ++current) {
+        It sift{ current };
+        It siftPrevious{ current - 1 };
+        if (comp(*sift, *siftPrevious)) {
+          auto value{ std::move(*sift) };
+          do {
+            *sift-- = std::move(*siftPrevious);
+          } while (sift != begin && comp(value, *--siftPrevious));
+          *sift = std::move(value);
+          moves += current - sift;
+        }
+        if (moves > partialInsertionSortLimit) return false;
+      }
+      return true;
+    }
+
+    template<typename It, typename Compare> void sort2(It a, It b, Compare comp)
+    {
+      if (comp(*b, *a)) std::iter_swap(a, b);
+    }
+
+    template<typename It, typename Compare> void sort3(It a, It b, It c, Compare comp)
+    {
+      sort2(a, b, comp);
+      sort2(b, c, comp);
+      sort2(a, b, comp);
+    }
+
+    // Partitions around the pivot *begin, elements equal to it end up on the right.
+    // Returns the pivot's final position, and whether the range was already partitioned (nothing had to be swapped).
+    template<typename It, typename Compare> std::pair<It, bool> partitionRight(It begin, It end, Compare comp)
+    {
+      auto pivot{ std::move(*begin) };
+      It first{ begin };
+      It last{ end };
+
+      // the pivot is a median of 3, so there's an element >= pivot to stop this scan
+      while (comp(*++first, pivot)) {}
+      // and if an element < pivot was found, it stops the other scan
+      if (first - 1 == begin) {
+        while (first < last && !comp(*--last, pivot)) {}
+      } else {
+        while (!comp(*--last, pivot)) {}
+      }
+
+      bool alreadyPartitioned{ first >= last };
+      while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(*++first, pivot)) {}
+        while (!comp(*--last, pivot)) {}
+      }
+
+      It pivotPosition{ first - 1 };
+      *begin = std::move(*pivotPosition);
+      *pivotPosition = std::move(pivot);
+      return { pivotPosition, alreadyPartitioned };
+    }
+
+    // Partitions around the pivot *begin with the elements equal to it on the left. Used when the pivot equals the
+    // element before the range, so every element equal to it is already in its final place.
+    template<typename It, typename Compare> It partitionLeft(It begin, It end, Compare comp)
+    {
+      auto pivot{ std::move(*begin) };
+      It first{ begin };
+      It last{ end };
+
+      while (comp(pivot, *--last)) {}
+      if (last + 1 == end) {
+        while (first < last && !comp(pivot, *++first)) {}
+      } else {
+        while (!comp(pivot, *++first)) {}
+      }
+
+      while (first < last) {
+        std::iter_swap(first, last);
+        while (comp(pivot, *--last)) {}
+        while (!comp(pivot, *++first)) {}
+      }
+
+      *begin = std::move(*last);
+      *last = std::move(pivot);
+      return last;
+    }
+
+    // Moves the elements at a quarter of the partition to its ends, so the next pivot comes from somewhere else
+    template<typename It> void shufflePivotCandidates(It begin, It end)
+    {
+      std::ptrdiff_t quarter{ (end - begin) / 4 };
+      std::iter_swap(begin, begin + quarter);
+      std::iter_swap(end - 1, end - quarter);
+      if (end - begin > nintherThreshold) {
+        std::iter_swap(begin + 1, begin + (quarter + 1));
+        std::iter_swap(begin + 2, begin + (quarter + 2));
+        std::iter_swap(end - 2, end - (quarter + 1));
+        std::iter_swap(end - 3, end - (quarter + 2));
+      }
+    }
+
+    template<typename It, typename Compare>
+    void pdqsortLoop(It begin, It end, Compare comp, int badPartitionsAllowed, bool leftmost)
+    {
+      while (true) {
+        std::ptrdiff_t size{ end - begin };
+        if (size < insertionSortThreshold) {
+          if (leftmost) {
+            insertionSort(begin, end, comp);
+          } else {
+            unguardedInsertionSort(begin, end, comp);
+          }
+          return;
+        }
+
+        // the pivot ends up in *begin
+        std::ptrdiff_t half{ size / 2 };
+        if (size > nintherThreshold) {
+          sort3(begin, begin + half, end - 1, comp);
+          sort3(begin + 1, begin + (half - 1), end - 2, comp);
+          sort3(begin + 2, begin + (half + 1), end - 3, comp);
+          sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+          std::iter_swap(begin, begin + half);
+        } else {
+          sort3(begin + half, begin, end - 1, comp);
+        }
+
+        // The element before a partition that isn't leftmost was a pivot, and no element in the partition is less
+        // than it. If it's equal to the new pivot too, take all the elements equal to it out in one pass.
+        if (!leftmost && !comp(*(begin - 1), *begin)) {
+          begin = partitionLeft(begin, end, comp) + 1;
+          continue;
+        }
+
+        auto [pivotPosition, alreadyPartitioned]{ partitionRight(begin, end, comp) };
+        std::ptrdiff_t leftSize{ pivotPosition - begin };
+        std::ptrdiff_t rightSize{ end - (pivotPosition + 1) };
+
+        if (leftSize < size / 8 || rightSize < size / 8) {
+          // too many bad pivots: this input defeats the pivot selection, heapsort guarantees O(n log n)
+          if (--badPartitionsAllowed == 0) {
+            std::make_heap(begin, end, comp);
+            std::sort_heap(begin, end, comp);
+            return;
+          }
+          if (leftSize >= insertionSortThreshold) shufflePivotCandidates(begin, pivotPosition);
+          if (rightSize >= insertionSortThreshold) shufflePivotCandidates(pivotPosition + 1, end);
+        } else if (alreadyPartitioned && partialInsertionSort(begin, pivotPosition, comp)
+                   && partialInsertionSort(pivotPosition + 1, end, comp)) {
+          // a balanced partition that needed no swaps is probably sorted already
+          return;
+        }
+
+        // recurse into the left part and loop on the right one
+        pdqsortLoop(begin, pivotPosition, comp, badPartitionsAllowed, leftmost);
+        begin = pivotPosition + 1;
+        leftmost = false;
+      }
+    }
+
+    template<typename T> void compareExchange(T& a, T& b)
+    {
+      T low{ std::min(a, b) };
+      b = std::max(a, b);
+      a = low;
+    }
+  } // namespace detail
+
+  template<std::random_access_iterator It, typename Compare = std::less<>>
+  void pdqsort(It begin, It end, Compare comp = Compare{})
+  {
+    if (end - begin < 2) return;
+    int badPartitionsAllowed{ static_cast<int>(std::bit_width(static_cast<std::size_t>(end - begin))) };
+    detail::pdqsortLoop(begin, end, comp, badPartitionsAllowed, true);
+  }
+
+  template<typename T, typename Compare = std::less<>> void pdqsort(std::span<T> values, Compare comp = Compare{})
+  {
+    pdqsort(values.begin(), values.end(), comp);
+  }
+
+  template<std::integral T>
+    requires(sizeof(T) == 4 || sizeof(T) == 8)
+  void radixSort(std::span<T> values)
+  {
+    using Unsigned = std::make_unsigned_t<T>;
+    constexpr std::size_t passes{ sizeof(T) };
+    // sorting on the unsigned key with the sign bit flipped puts negative numbers first
+    constexpr Unsigned flip{ std::is_signed_v<T> ? Unsigned{ 1 } << (sizeof(T) * 8 - 1) : Unsigned{ 0 } };
+
+    if (values.size() < static_cast<std::size_t>(detail::insertionSortThreshold)) {
+      detail::insertionSort(values.begin(), values.end(), std::less<>{});
+      return;
+    }
+
+    // the histograms of all passes are counted in a single read of the input
+    std::array<std::array<std::size_t, 256>, passes> counts{};
+    for (T value : values) {
+      Unsigned key{ static_cast<Unsigned>(static_cast<Unsigned>(value) ^ flip) };
+      for (std::size_t pass{ 0 }; pass < passes; ++pass) ++counts[pass][(key >> (pass * 8)) & 0xFF];
+    }
+
+    auto buffer{ std::make_unique_for_overwrite<T[]>(values.size()) };
+    T* from{ values.data() };
+    T* to{ buffer.get() };
+    for (std::size_t pass{ 0 }; pass < passes; ++pass) {
+      Unsigned firstKey{ static_cast<Unsigned>(static_cast<Unsigned>(values[0]) ^ flip) };
+      if (counts[pass][(firstKey >> (pass * 8)) & 0xFF] == values.size()) continue; // every key has the same byte
+
+      std::array<std::size_t, 256> offsets{};
+      std::size_t offset{ 0 };
+      for (std::size_t digit{ 0 }; digit < 256; ++digit) {
+        offsets[digit] = offset;
+        offset += counts[pass][digit];
+      }
+      for (std::size_t i{ 0 }; i < values.size(); ++i) {
+        Unsigned key{ static_cast<Unsigned>(static_cast<Unsigned>(from[i]) ^ flip) };
+        to[offsets[(key >> (pass * 8)) & 0xFF]++] = from[i];
+      }
+      std::swap(from, to);
+    }
+    if (from != values.data()) std::copy_n(from, values.size(), values.data());
+  }
+
+  namespace detail {
+    // Calls function(i, j) for every compare-exchange of Batcher's merge-exchange sort of n elements (Knuth, TAOCP
+    // vol. 3, algorithm 5.2.2M)
+    template<typename Function> constexpr void forEachBatcherPair(std::size_t n, Function function)
+    {
+      if (n < 2) return;
+      std::size_t top{ std::size_t{ 1 } << (std::bit_width(n - 1) - 1) };
+      for (std::size_t p{ top }; p > 0; p >>= 1) {
+        std::size_t q{ top };
+        std::size_t r{ 0 };
+        std::size_t d{ p };
+        while (true) {
+          for (std::size_t i{ 0 }; i + d < n; ++i) {
+            if ((i & p) == r) function(i, i + d);
+          }
+          if (q == p) break;
+          d = q - p;
+          q >>= 1;
+          r = p;
+        }
+      }
+    }
+
+    template<std::size_t N> constexpr auto batcherPairs()
+    {
+      constexpr std::size_t count{ [] {
+        std::size_t c{ 0 };
+        forEachBatcherPair(N, [&c](std::size_t, std::size_t) { ++c; });
+        return c;
+      }() };
+      std::array<std::pair<std::size_t, std::size_t>, count> pairs{};
+      std::size_t next{ 0 };
+      forEachBatcherPair(N, [&](std::size_t i, std::size_t j) { pairs[next++] = { i, j }; });
+      return pairs;
+    }
+  } // namespace detail
+
+  // Sorts exactly N elements. The network is computed at compile time, so this is straight-line code: one min and one
+  // max per pair.
+  template<std::size_t N, typename T> void sortingNetwork(T* values)
+  {
+    static constexpr auto pairs{ detail::batcherPairs<N>() };
+    [values]<std::size_t... I>(std::index_sequence<I...>) {
+      (detail::compareExchange(values[pairs[I].first], values[pairs[I].second]), ...);
+    }(std::make_index_sequence<pairs.size()>{});
+  }
+
+  constexpr std::size_t maxNetworkSize{ 16 };
+
+  // Sorts at most maxNetworkSize elements with the sorting network for their count
+  template<typename T> void networkSort(std::span<T> values)
+  {
+    assert(values.size() <= maxNetworkSize && "Sort::networkSort(): too many elements");
+    static constexpr auto networks{ []<std::size_t... N>(std::index_sequence<N...>) {
+      return std::array{ &sortingNetwork<N, T>... };
+    }(std::make_index_sequence<maxNetworkSize + 1>{}) };
+    networks[values.size()](values.data());
+  }
+} // namespace Sort
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef STRING_SORT_H
+#define STRING_SORT_H
+
+#include <algorithm> // for std::max_element, std::min
+#include <bit> // for std::byteswap, std::endian
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // for std::memcpy
+#include <functional> // for std::invoke
+#include <iterator> // for std::begin, std::end
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+Sorting of strings, and of records by string keys, with caching multikey quicksort (Bentley & Sedgewick, with the
+8-byte caching from Bingmann's string sorting work).
+
+std::sort compares whole strings: every comparison follows two pointers and compares from the first character, even
+when the strings share a long prefix that every earlier comparison has already seen. Multikey quicksort instead sorts
+on one position of the strings at a time and never looks at a position again once the strings agree on it. Here a
+"position" is 8 characters: every string has the next 8 bytes of its key cached as a big-endian integer next to it, so
+most comparisons are one integer comparison in a contiguous array, without touching the characters at all.
+
+- A range is split three ways by the cached prefixes: less than, equal to and greater than a pivot prefix. The less
+  and greater parts are sorted at the same depth. The largest of the three parts is sorted by the loop, the others
+  recursively, so the stack stays O(log n) deep whatever the input.
+- Strings of the equal part agree on 8 more characters. Those that end within them come first, the rest get the next 8
+  bytes cached and are sorted at depth + 8.
+- Ranges of fewer than 16 strings are insertion sorted.
+*/
+namespace Sort {
+  namespace detail {
+    struct StringEntry
+    {
+      std::uint64_t prefix{}; // characters [depth, depth + 8) of the string, big-endian, zero-padded
+      std::string_view string{};
+      std::size_t index{}; // position before sorting
+    };
+
+    constexpr std::size_t stringInsertionSortThreshold{ 16 };
+
+    inline std::uint64_t loadPrefix(std::string_view string, std::size_t depth)
+    {
+      std::uint64_t prefix{ 0 };
+      if (depth < string.size()) {
+        std::memcpy(&prefix, string.data() + depth, std::min<std::size_t>(8, string.size() - depth));
+      }
+      if constexpr (std::endian::native == std::endian::little) prefix = std::byteswap(prefix);
+      return prefix;
+    }
+
+    // Every string in the range shares its first depth characters
+    inline bool lessFrom(const StringEntry& a, const StringEntry& b, std::size_t depth)
+    {
+      if (a.prefix != b.prefix) return a.prefix < b.prefix;
+      return a.string.substr(depth) < b.string.substr(depth);
+    }
+
+    inline void insertionSortStrings(StringEntry* first, StringEntry* last, std::size_t depth)
+    {
+      for (StringEntry* current{ first + 1 }; current < last; ++current) {
+        StringEntry value{ *current };
+        StringEntry* sift{ current };
+        for (; sift > first && lessFrom(value, *(sift - 1), depth); --sift) *sift = *(sift - 1);
+        *sift = value;
+      }
+    }
+
+    inline std::uint64_t medianOf3(std::uint64_t a, std::uint64_t b, std::uint64_t c)
+    {
+      if (a < b) return b < c ? b : (a < c ? c : a);
+      return a < c ? a : (b < c ? c : b);
+    }
+
+    inline void multikeyQuicksort(StringEntry* first, StringEntry* last, std::size_t depth)
+    {
+      while (last - first >= static_cast<std::ptrdiff_t>(stringInsertionSortThreshold)) {
+        std::ptrdiff_t size{ last - first };
+        std::uint64_t pivot{ medianOf3(first->prefix, first[size / 2].prefix, (last - 1)->prefix) };
+
+        // Dutch national flag partition: [first, less) < pivot, [less, i) == pivot, [greater, last) > pivot
+        StringEntry* less{ first };
+        StringEntry* i{ first };
+        StringEntry* greater{ last };
+        while (i < greater) {
+          if (i->prefix < pivot) {
+            std::swap(*less++, *i++);
+          } else if (i->prefix > pivot) {
+            std::swap(*i, *--greater);
+          } else {
+            ++i;
+          }
+        }
+
+        // Strings that end within these 8 characters are prefixes of the others, so they go first (the shorter, the
+        // earlier: "ab" < "ab\0"). The rest continue with the next 8 characters.
+        StringEntry* unfinished{ less };
+        for (StringEntry* e{ less }; e < greater; ++e) {
+          if (e->string.size() <= depth + 8) std::swap(*e, *unfinished++);
+        }
+        insertionSortStrings(less, unfinished, depth);
+        for (StringEntry* e{ unfinished }; e < greater; ++e) e->prefix = loadPrefix(e->string, depth + 8);
+
+        // Recursing only into the two smaller parts and looping on the largest keeps the recursion O(log n) deep:
+        // neither of the smaller parts can hold more than half of the range
+        struct Part
+        {
+          StringEntry* first{};
+          StringEntry* last{};
+          std::size_t depth{};
+        };
+        Part parts[]{ { first, less, depth }, { greater, last, depth }, { unfinished, greater, depth + 8 } };
+        Part* largest{ std::max_element(std::begin(parts), std::end(parts),
+          [](const Part& a, const Part& b) { return a.last - a.first < b.last - b.first; }) };
+        for (const Part& part : parts) {
+          if (&part != largest) multikeyQuicksort(part.first, part.last, part.depth);
+        }
+
+        first = largest->first;
+        last = largest->last;
+        depth = largest->depth;
+      }
+      insertionSortStrings(first, last, depth);
+    }
+
+    // Entries of the keys key(0), ..., key(count - 1) in sorted order
+    template<typename Key> std::vector<StringEntry> sortEntries(std::size_t count, Key key)
+    {
+      std::vector<StringEntry> entries(count);
+      for (std::size_t i{ 0 }; i < count; ++i) {
+        std::string_view string{ key(i) };
+        entries[i] = { loadPrefix(string, 0), string, i };
+      }
+      if (!entries.empty()) multikeyQuicksort(entries.data(), entries.data() + entries.size(), 0);
+      return entries;
+    }
+
+    // Sorts the indices of the records by the first key, then every run with equal first keys by the second and so on.
+    // The records themselves don't move, so the views of their keys stay valid throughout.
+    template<typename T, typename Key, typename... Keys>
+    void sortIndicesByKeys(std::span<const T> records, std::span<std::size_t> indices, Key key, Keys... keys)
+    {
+      std::vector<StringEntry> entries{ sortEntries(indices.size(), [&](std::size_t i) {
+        return key(records[indices[i]]);
+      }) };
+      for (std::size_t i{ 0 }; i < entries.size(); ++i) entries[i].index = indices[entries[i].index];
+      for (std::size_t i{ 0 }; i < entries.size(); ++i) indices[i] = entries[i].index;
+
+      if constexpr (sizeof...(Keys) > 0) {
+        std::size_t runBegin{ 0 };
+        for (std::size_t i{ 1 }; i <= entries.size(); ++i) {
+          if (i < entries.size() && entries[i].string == entries[runBegin].string) continue;
+          if (i - runBegin > 1) sortIndicesByKeys(records, indices.subspan(runBegin, i - runBegin), keys...);
+          runBegin = i;
+        }
+      }
+    }
+  } // namespace detail
+
+  // Sorts the views (not the characters they point to) in lexicographic order, like std::sort on std::string_view
+  inline void sortStrings(std::span<std::string_view> strings)
+  {
+    std::vector<detail::StringEntry> entries{ detail::sortEntries(strings.size(), [&](std::size_t i) {
+      return strings[i];
+    }) };
+    for (std::size_t i{ 0 }; i < strings.size(); ++i) strings[i] = entries[i].string;
+  }
+
+  /*
+  Sorts records by one or more string keys, e.g. cars by make and then model:
+    Sort::sortByStringKeys(std::span{ cars }, &Car::getMake, &Car::getModel);
+  Every key is a callable that returns a std::string_view, or a reference to something convertible to one, into the
+  record. Records are compared on a later key only when all the earlier ones are equal, and each key is compared once
+  per level instead of being recompared by every operator< call. Not stable beyond the keys given.
+  */
+  template<typename T, typename... Keys> void sortByStringKeys(std::span<T> records, Keys... keys)
+  {
+    static_assert(sizeof...(Keys) > 0, "Sort::sortByStringKeys(): needs at least one key");
+    // A key returned by value (a std::string copy) would be destroyed before the sort reads the view of it
+    static_assert(((std::is_lvalue_reference_v<std::invoke_result_t<Keys&, const T&>>
+                     || std::is_same_v<std::remove_cv_t<std::invoke_result_t<Keys&, const T&>>, std::string_view>)
+                    && ...),
+      "Sort::sortByStringKeys(): every key must return a reference into the record or a std::string_view");
+    std::vector<std::size_t> indices(records.size());
+    for (std::size_t i{ 0 }; i < indices.size(); ++i) indices[i] = i;
+    detail::sortIndicesByKeys(std::span<const T>{ records }, std::span{ indices }, [keys](const T& record) {
+      return std::string_view{ std::invoke(keys, record) };
+    }...);
+
+    // every record is moved twice, once the order is known
+    std::vector<T> sorted{};
+    sorted.reserve(records.size());
+    for (std::size_t index : indices) sorted.push_back(std::move(records[index]));
+    std::move(sorted.begin(), sorted.end(), records.begin());
+  }
+} // namespace Sort
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm> // for std::max
+#include <condition_variable>
+#include <functional> // for std::move_only_function
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+Fixed number of worker threads that run submitted tasks in FIFO order. Starting a thread costs tens of microseconds, so
+algorithms that split their work into tasks many times (every parallel sort call, every round of a merge) reuse the
+threads of a pool instead.
+
+submit() returns a std::future for the task's result, and rethrows the task's exception from get(). A task must not
+wait for another task of the same pool: with every worker waiting, nothing would be left to run the task waited for.
+
+The destructor runs the tasks already queued, then joins the workers.
+*/
+class ThreadPool
+{
+public:
+  explicit ThreadPool(unsigned threadCount = std::max(1u, std::thread::hardware_concurrency()))
+  {
+    m_threads.reserve(threadCount);
+    for (unsigned i{ 0 }; i < threadCount; ++i) m_threads.emplace_back([this] { work(); });
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool()
+  {
+    {
+      std::lock_guard lock{ m_mutex };
+      m_stopping = true;
+    }
+    m_condition.notify_all();
+    // the std::jthreads join when m_threads is destroyed, before the queue and the mutex are
+  }
+
+  template<typename Function> std::future<std::invoke_result_t<Function>> submit(Function function)
+  {
+    std::packaged_task<std::invoke_result_t<Function>()> task{ std::move(function) };
+    auto result{ task.get_future() };
+    {
+      std::lock_guard lock{ m_mutex };
+      m_tasks.emplace(std::move(task));
+    }
+    m_condition.notify_one();
+    return result;
+  }
+
+  unsigned size() const { return static_cast<unsigned>(m_threads.size()); }
+
+  // Shared pool with a thread per core, created on first use
+  static ThreadPool& global()
+  {
+    static ThreadPool pool{};
+    return pool;
+  }
+
+private:
+  std::mutex m_mutex{};
+  std::condition_variable m_condition{};
+  std::queue<std::move_only_function<void()>> m_tasks{};
+  bool m_stopping{ false };
+  std::vector<std::jthread> m_threads{}; // declared last, so the workers are joined first
+
+  void work()
+  {
+    while (true) {
+      std::move_only_function<void()> task{};
+      {
+        std::unique_lock lock{ m_mutex };
+        m_condition.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+        if (m_tasks.empty()) return; // stopping, and nothing left to do
+        task = std::move(m_tasks.front());
+        m_tasks.pop();
+      }
+      task();
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <chrono> // for std::chrono functions
+
+// Header-only stopwatch used by the benchmark programs.
+// Courtesy of learncpp.com (https://www.learncpp.com/cpp-tutorial/timing-your-code/)
+class Timer
+{
+private:
+  // Type aliases to make accessing nested type easier
+  using Clock = std::chrono::steady_clock;
+  using Second = std::chrono::duration<double, std::ratio<1>>;
+
+  std::chrono::time_point<Clock> m_beg{ Clock::now() };
+
+public:
+  void reset() { m_beg = Clock::now(); }
+
+  // Seconds since construction or the last reset()
+  double elapsed() const { return std::chrono::duration_cast<Second>(Clock::now() - m_beg).count(); }
+};
+
+#endif